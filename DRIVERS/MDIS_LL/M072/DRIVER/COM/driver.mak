@@ -54,8 +54,10 @@ MAK_INCL=$(MEN_MOD_DIR)/m72_pld.h     \
 
 MAK_INP1=m72_drv$(INP_SUFFIX)
 MAK_INP2=m72_pld$(INP_SUFFIX)
+MAK_INP3=m72_pld_01$(INP_SUFFIX)
 
 MAK_INP=$(MAK_INP1) \
-        $(MAK_INP2)
+        $(MAK_INP2) \
+        $(MAK_INP3)
 
  
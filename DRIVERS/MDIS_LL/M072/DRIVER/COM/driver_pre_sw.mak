@@ -1,63 +0,0 @@
-#***************************  M a k e f i l e  *******************************
-#
-#         Author: ts
-#
-#    Description: Makefile definitions for the M72 driver, Pretrigger
-#                 Variant
-#
-#-----------------------------------------------------------------------------
-#   Copyright 2002-2019, MEN Mikro Elektronik GmbH
-#*****************************************************************************
-# This program is free software: you can redistribute it and/or modify
-# it under the terms of the GNU General Public License as published by
-# the Free Software Foundation, either version 2 of the License, or
-# (at your option) any later version.
-#
-# This program is distributed in the hope that it will be useful,
-# but WITHOUT ANY WARRANTY; without even the implied warranty of
-# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-# GNU General Public License for more details.
-#
-# You should have received a copy of the GNU General Public License
-# along with this program.  If not, see <http://www.gnu.org/licenses/>.
-
-MAK_NAME=m72_pre_sw
-# the next line is updated during the MDIS installation
-STAMPED_REVISION="13M072-06_03_05-3-g9a820db-dirty_2019-05-10"
-
-DEF_REVISION=MAK_REVISION=$(STAMPED_REVISION)
-
-MAK_SWITCH=$(SW_PREFIX)MAC_MEM_MAPPED\
-		$(SW_PREFIX)$(DEF_REVISION) \
-		$(SW_PREFIX)MAC_BYTESWAP \
-		$(SW_PREFIX)M72_VARIANT=M72_PRE_SW \
-		$(SW_PREFIX)ID_SW \
-		$(SW_PREFIX)PLD_SW
-
-MAK_LIBS=$(LIB_PREFIX)$(MEN_LIB_DIR)/desc$(LIB_SUFFIX) \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/oss$(LIB_SUFFIX) \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/id_sw$(LIB_SUFFIX) \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/pld_sw$(LIB_SUFFIX) \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/dbg$(LIB_SUFFIX) \
-
-MAK_INCL=$(MEN_MOD_DIR)/m72_pld.h     \
-		 $(MEN_INC_DIR)/m72_drv.h     \
-         $(MEN_INC_DIR)/men_typs.h    \
-         $(MEN_INC_DIR)/oss.h         \
-         $(MEN_INC_DIR)/mdis_err.h    \
-         $(MEN_INC_DIR)/maccess.h     \
-         $(MEN_INC_DIR)/desc.h        \
-         $(MEN_INC_DIR)/pld_load.h    \
-         $(MEN_INC_DIR)/mdis_api.h    \
-         $(MEN_INC_DIR)/mdis_com.h    \
-         $(MEN_INC_DIR)/microwire.h      \
-         $(MEN_INC_DIR)/ll_defs.h     \
-         $(MEN_INC_DIR)/ll_entry.h    \
-         $(MEN_INC_DIR)/dbg.h         \
-
-MAK_INP1=m72_drv_pretrig$(INP_SUFFIX)
-MAK_INP2=m72_pld_01$(INP_SUFFIX)
-
-MAK_INP=$(MAK_INP1) \
-        $(MAK_INP2)
- 
@@ -21,7 +21,11 @@
  *               
  *               Writing to a channel loads the counter, reading from a 
  *               channel reads the counter, depending on the read/write mode
- *               used. Block I/O is not supported.
+ *               used. A block read returns a coherent snapshot of all
+ *               channels, drains the channel's event FIFO or waits for
+ *               events of all channels in the event queue. FIFO and queue
+ *               are filled by the interrupt service routine. A block write
+ *               loads the preload registers of several channels at once.
  *
  *               The mode for write and read access can be configured.
  *
@@ -33,6 +37,18 @@
  *
  *     Required: OSS, DESC, PLD, ID, DBG libraries
  *     Switches: _ONE_NAMESPACE_PER_DRIVER_
+ *               M72_IRQ_PROFILE	ISR duration/latency histograms
+ *               					(see M72_GetStat: M72_BLK_IRQ_PROFILE)
+ *               M72_EVRING_SHARED	event ring address export for OSes
+ *               					where driver and applications share
+ *               					one address space
+ *               					(see M72_GetStat: M72_EVRING_ADDR)
+ *               M72_TIMESTAMP(llHdl), M72_TIMESTAMP_RATE(llHdl)
+ *               					platform clock for the timestamps
+ *               					without timebase channel and its
+ *               					rate (default: Linux monotonic
+ *               					clock [us] or OS ticks)
+ *               					(see M72_GetStat: M72_TIME_RATE)
  *
  *---------------------------------------------------------------------------
  * Copyright 2010-2019, MEN Mikro Elektronik GmbH
@@ -66,6 +82,9 @@
 #include <MEN/mdis_err.h>   /* MDIS error codes               */
 #include <MEN/ll_defs.h>    /* low-level driver definitions   */
 #include "m72_pld.h"		/* PLD ident/data prototypes      */
+#if defined(LINUX) && defined(__KERNEL__) && !defined(M72_TIMESTAMP)
+# include <linux/ktime.h>	/* monotonic clock (timestamps)   */
+#endif
 
 /*-----------------------------------------+
 |  DEFINES                                 |
@@ -79,6 +98,13 @@
 #define MOD_ID_SIZE			128			/* ID PROM size [bytes] */
 #define MOD_ID				72			/* ID PROM module ID */
 #define SIG_COUNT			5			/* number of signals per channel */
+#define FIFO_DEPTH_MAX		0x10000		/* max. FIFO entries per channel */
+#define EVRING_SIZE_MAX		0x10000		/* max. event ring records */
+#define EVQUEUE_DEPTH_MAX	0x10000		/* max. event queue entries */
+#define CAM_SIZE_MAX		0x10000		/* max. cam table entries */
+#define DEFER_DEPTH			64			/* deferred irq work entries (2^n) */
+#define DEFER_PERIOD_MAX	1000		/* max. deferred irq work period [ms] */
+#define PROF_BINS			32			/* =M72_PROFILE_BINS */
 
 /* debug settings */
 #define DBG_MYLEVEL			llHdl->dbgLevel
@@ -120,12 +146,69 @@
 #define ENB_MASK		0x0080		
 
 /* IRQ_STATE_REG (i=channel) */
+#define CHAN_PEND_MASK	0x1f
+
+/* timebase channel: clock of timer mode [Hz] */
+#define TIMEBASE_RATE		2500000
+
+/* pretrigger defaults: channels, edge fractions, output line */
+#define PRETR_TIMER_A 0							/* period timer */
+#define PRETR_TIMER_B 1							/* set edge timer */
+#define PRETR_TIMER_C 2							/* clear edge timer */
+#define PRETR_FRAC_B  M72_PRETRIG_FRAC_ONE		/* set at full period */
+#define PRETR_FRAC_C  (M72_PRETRIG_FRAC_ONE/2)	/* clear at half period */
+#define PRETR_OUT     4							/* OUT4 */
+#define PRETR_OFFSET  25						/* min. pretrigger offset */
+#define PRETR_HSHIFT  8							/* histogram bin width */
+#define PRETR_DEV_MAX 0xffff					/* max. squared deviation */
+#define PRETR_HIST_BINS 32						/* =M72_PRETRIG_HIST_BINS */
+#define PRETR_PRED    0							/* last period */
+#define PRETR_PRED_K  2							/* window 4, gain 1/4 */
+#define PRETR_WIN_MAX 16						/* =1<<M72_PRED_K_MAX */
+#define PRETR_TREND_FRAC 8						/* fraction bits of slope */
+#define PRETR_TREND_MAX  (0x7fffffff >> (PRETR_TREND_FRAC+1))
+												/* max. slope [ticks] */
+
+/* pretrigger timer control: period (latch/clear at xIN2), edge (preload) */
+#define PRETR_CTRL_PERIOD	0x0aa1
+#define PRETR_CTRL_EDGE		0x0a04
+
+/* timestamp of interrupt events without timebase channel and timestamps
+   per second: Linux monotonic clock [us], else OS ticks
+   (may be replaced by a platform specific high resolution clock) */
+#ifndef M72_TIMESTAMP
+# if defined(LINUX) && defined(__KERNEL__)
+#  define M72_TIMESTAMP(llHdl)		((u_int32)ktime_to_us(ktime_get()))
+#  define M72_TIMESTAMP_RATE(llHdl)	1000000
+# else
+#  define M72_TIMESTAMP(llHdl)		((u_int32)OSS_TickGet((llHdl)->osHdl))
+#  define M72_TIMESTAMP_RATE(llHdl)	((u_int32)OSS_TickRateGet((llHdl)->osHdl))
+# endif
+#endif
 #define READY_PEND(i)	0x1<<((i)<<3)	
 #define COMP_PEND(i)	0x2<<((i)<<3)	
 #define CYBW_PEND(i)	0x4<<((i)<<3)	
 #define LBREAK_PEND(i)	0x8<<((i)<<3)	
 #define XIN2_PEND(i)	0x10<<((i)<<3) 
 
+/* irq work: storage of the counter latch (see IrqStore) */
+#define STORE_FIFO		0x01		/* channel FIFO */
+#define STORE_EV		0x02		/* event ring/event queue */
+
+/* index of lowest set bit (v != 0) */
+#define FIRST_BIT(v)	G_firstBit[(u_int32)(((v) & (0-(v))) * 0x077cb531UL) >> 27]
+
+/* setstat list: registers to write (see SetStatList) */
+#define DIRTY_COUNT_CTRL	0x01
+#define DIRTY_IRQ_CTRL		0x02
+#define DIRTY_COMPA			0x04
+#define DIRTY_COMPB			0x08
+#define DIRTY_OUT_CTRL		0x10
+#define DIRTY_OUT_SET		0x20
+#define DO_CLEAR_NOW		0x40
+#define DO_PRELOAD_NOW		0x80
+#define DO_STORE_NOW		0x100
+
 /* PLD_IF_REG: PLD bit locations */
 #define PSDAT			0	
 #define PSCLK			1
@@ -139,6 +222,127 @@
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
+/* per channel FIFO (filled by M72_Irq) */
+typedef struct {
+	struct M72_FIFO_ENTRY *buf;		/* entry buffer (see m72_drv.h) */
+	u_int32			bufSize;		/* allocated size of buffer */
+	u_int32			depth;			/* number of entries */
+	u_int32			in;				/* write index (M72_Irq) */
+	u_int32			out;			/* read index */
+	u_int32			count;			/* number of stored entries */
+	u_int32			seq;			/* next sequence number */
+	u_int32			overrun;		/* number of lost entries */
+	u_int32			events;			/* irq events to store (M72_INT_xxx) */
+	u_int32			readSeq;		/* seq. number of last M72_Read */
+} FIFO;
+
+/* module event queue (filled by M72_Irq) */
+typedef struct {
+	struct M72_EVENT *buf;			/* entry buffer (see m72_drv.h) */
+	u_int32			bufSize;		/* allocated size of buffer */
+	u_int32			depth;			/* number of entries */
+	u_int32			in;				/* write index (M72_Irq) */
+	u_int32			out;			/* read index */
+	u_int32			count;			/* number of stored entries */
+	u_int32			seq;			/* next sequence number */
+	u_int32			overrun;		/* number of lost entries */
+	OSS_SEM_HANDLE  *semHdl;		/* event semaphore */
+} EVQUEUE;
+
+/* irq work (see IrqWork) */
+typedef struct {
+	u_int32			irqState;	/* pending irq flags */
+	u_int32			stampLow;	/* time of irq (see M72_CNT64) */
+	u_int32			stampHigh;
+	u_int32			fifoStore;	/* channels to store in FIFO (bit n) */
+	u_int32			evStore;	/* channels to store in event ring/queue */
+	u_int32			value[CH_NUMBER];	/* latched counter values */
+	u_int32			fifoLost[CH_NUMBER];	/* dropped FIFO events (DeferPut) */
+	u_int32			evLost[CH_NUMBER];		/* dropped event queue events */
+} IRQ_WORK;
+
+/* deferred irq work queue (filled by M72_Irq) */
+typedef struct {
+	IRQ_WORK		buf[DEFER_DEPTH];	/* entry buffer */
+	IRQ_WORK		spare;		/* work of a full queue (see DeferPut) */
+	u_int32			in;			/* write index (M72_Irq) */
+	u_int32			out;		/* read index (IrqDefer) */
+	u_int32			period;		/* alarm period [ms] (0=not deferred) */
+	u_int32			overrun;	/* irqs (partly) dropped, queue full */
+	u_int32			busy;		/* queue owned by IrqDefer/DeferSet */
+	OSS_ALARM_HANDLE *alarmHdl;	/* cyclic alarm */
+} DEFER;
+
+#ifdef M72_IRQ_PROFILE
+/* ISR profile (see M72_BLK_IRQ_PROFILE) */
+typedef struct {
+	u_int32			count;		/* measured interrupts */
+	u_int32			durLast;	/* last ISR duration */
+	u_int32			durMax;		/* max. ISR duration */
+	u_int32			latCount;	/* latency samples */
+	u_int32			latLast;	/* last event-to-ISR latency */
+	u_int32			latMax;		/* max. event-to-ISR latency */
+	u_int32			durHist[PROF_BINS];	/* duration histogram */
+	u_int32			latHist[PROF_BINS];	/* latency histogram */
+} IRQ_PROF;
+#endif
+
+/* comparator cam table */
+typedef struct {
+	u_int32			*buf;		/* compare positions (list mode) */
+	u_int32			bufSize;	/* allocated size of buf */
+	u_int32			mode;		/* cam mode (M72_CAM_xxx) */
+	u_int32			loop;		/* restart list at end */
+	u_int32			incr;		/* increment (M72_CAM_INCR) */
+	u_int32			count;		/* number of compare positions */
+	u_int32			idx;		/* index of next position */
+	u_int32			matches;	/* comparator matches since load */
+	u_int32			underrun;	/* late intervals (M72_CAM_SEQ) */
+} CAM;
+
+/* pretrigger period statistics */
+typedef struct {
+	u_int32			count;		/* number of periods */
+	u_int32			min;		/* min. period */
+	u_int32			max;		/* max. period */
+	u_int32			ref;		/* reference period (first after clear) */
+	u_int32			sumLow;		/* sum of deviations from ref, bits 0..31 */
+	u_int32			sumHigh;	/* bits 32..63 (two's compl.) */
+	u_int32			sqLow;		/* sum of squared deviations, bits 0..31 */
+	u_int32			sqHigh;		/* bits 32..63 */
+	u_int32			late;		/* late preloads */
+	u_int32			histBase;	/* lower bound of bin 0 */
+	u_int32			histShift;	/* bin width = 1 << histShift */
+	u_int32			histUnder;	/* periods below bin 0 */
+	u_int32			histOver;	/* periods above last bin */
+	u_int32			outliers;	/* rejected periods */
+	u_int32			errLow;		/* sum of abs. prediction errors, 0..31 */
+	u_int32			errHigh;	/* bits 32..63 */
+	u_int32			errMax;		/* max. abs. prediction error */
+	u_int32			latency;	/* last preload latency */
+	u_int32			latMax;		/* max. preload latency */
+	u_int32			latLow;		/* sum of preload latencies, bits 0..31 */
+	u_int32			latHigh;	/* bits 32..63 */
+	u_int32			compensated;/* latency compensated edges */
+	u_int32			missed;		/* edges not compensated */
+	u_int32			hist[PRETR_HIST_BINS];	/* histogram bins */
+} PRETRIG_STAT;
+
+/* pretrigger period predictor state */
+typedef struct {
+	u_int32			valid;		/* number of periods since reset */
+	u_int32			pred;		/* predicted next period */
+	u_int32			level;		/* smoothed period (EXP, TREND) */
+	int32			trend;		/* smoothed slope (TREND), */
+								/* 1/2^PRETR_TREND_FRAC ticks */
+	int32			rem;		/* level division remainder (TREND) */
+	u_int32			sumLow;		/* window sum (AVG), bits 0..31 */
+	u_int32			sumHigh;	/* bits 32..63 */
+	u_int32			idx;		/* window index (AVG) */
+	u_int32			outl;		/* consecutive outliers */
+	u_int32			win[PRETR_WIN_MAX];	/* period window (AVG) */
+} PRETRIG_PRED;
+
 /* low-level handle */
 typedef struct {
 	/* general */
@@ -153,6 +357,14 @@ typedef struct {
 	DBG_HANDLE      *dbgHdl;        /* debug handle */
 	/* misc */
     u_int32         irqCount;       /* interrupt counter */
+    u_int32         irqReject;      /* rejected (not caused) interrupts */
+    u_int32         irqEnbMask;     /* pending bits of enabled channels */
+    u_int32         actPend;        /* pending bits with consumer (IrqActMask) */
+    u_int32         hwPend;         /* pending bits handled by the driver */
+    u_int32         fifoPend;       /* pending bits stored in the FIFO */
+    u_int32         evPend;         /* pending bits stored in ev. ring/queue */
+    u_int32         wakePend;       /* pending bits releasing a read */
+    u_int32         osPend;         /* pending bits with OS-level work */
     u_int32         idCheck;		/* id check enabled */
 	MCRW_HANDLE		*mcrwHdl;		
 	/* shadow registers */
@@ -168,6 +380,20 @@ typedef struct {
     u_int32         readTimeout[CH_NUMBER];	 /* read timeout */
     u_int32         writeMode[CH_NUMBER];	 /* write mode */
     OSS_SEM_HANDLE  *readSemHdl[CH_NUMBER];  /* ready semaphore (read) */
+    u_int32         blkReadMode[CH_NUMBER];	 /* block read mode */
+	FIFO			fifo[CH_NUMBER];		 /* event FIFO */
+	/* event ring */
+	struct M72_EVRING *evRing;				/* ring (see m72_drv.h) */
+	u_int32			evRingAlloc;			/* allocated size of ring */
+	u_int32			evRingMask;				/* number of records - 1 */
+	/* event queue */
+	EVQUEUE			evq;					/* queue of all channels */
+	/* deferred irq work */
+	DEFER			defer;					/* (see M72_IRQ_DEFER) */
+#ifdef M72_IRQ_PROFILE
+	/* ISR profile */
+	IRQ_PROF		prof;					/* (see M72_BLK_IRQ_PROFILE) */
+#endif
 	/* counter config */
     u_int32         cntMode[CH_NUMBER];		/* counter mode */
     u_int32         cntPreload[CH_NUMBER];	/* counter preload condition */
@@ -185,8 +411,41 @@ typedef struct {
     u_int32         valCompB[CH_NUMBER];	/* comparator B value */
 	/* timer config */
     u_int32         timerStart[CH_NUMBER];	/* timer start condition */
+	/* continuous measurement */
+    u_int32         continuous[CH_NUMBER];	/* restart meas. at Ready irq */
+	/* 64-bit counter extension */
+    u_int32         ext64[CH_NUMBER];		/* extension enabled */
+    u_int32         cntHigh[CH_NUMBER];		/* counter bits 32..63 */
+	/* timebase */
+    u_int32         tbChan;					/* timebase channel */
+	/* xIN2 capture */
+    u_int32         capture[CH_NUMBER];		/* capture mode enabled */
+	/* comparator cam table */
+	CAM				cam[CH_NUMBER];			/* cam table */
+	/* pretrigger engine */
+	u_int32 		cntPretrig;				/* clk-count to pretrig. Timer	*/
+	u_int32 		enPretrig;				/* pretrigger enabled (user) 	*/
+	u_int32 		ptActive;				/* pretrigger engine running 	*/
+	u_int32 		ptPeriod;				/* period timer channel 		*/
+	u_int32 		ptSet;					/* set edge timer channel 		*/
+	u_int32 		ptClr;					/* clear edge timer channel 	*/
+	u_int32 		ptFracSet;				/* set edge period fraction 	*/
+	u_int32 		ptFracClr;				/* clear edge period fraction 	*/
+	u_int32 		ptOut;					/* output line (1..4) 			*/
+	PRETRIG_STAT	ptStat;					/* period statistics 			*/
+	u_int32 		ptPredMode;				/* predictor (M72_PRED_xxx) 	*/
+	u_int32 		ptPredK;				/* window 1<<k, gain 1/(1<<k) 	*/
+	u_int32 		ptBand;					/* outlier band (0=off) 		*/
+	PRETRIG_PRED	ptPred;					/* predictor state 				*/
+	u_int32 		ptLatComp;				/* latency compensation 		*/
+	u_int32 		ptLoadSet;				/* running set edge preload 	*/
+	u_int32 		ptLoadClr;				/* running clr edge preload 	*/
+	u_int32 		ptLatch;				/* last period latch 			*/
 	/* signals */
     OSS_SIG_HANDLE  *sigHdl[CH_NUMBER][SIG_COUNT];  /* signal handles */
+    u_int32         sigPend;        /* pending bits with installed signal */
+	/* timestamps */
+    u_int32         evTime[CH_NUMBER][SIG_COUNT];   /* time of last irq event */
 } LL_HANDLE;
 
 /* include files which need LL_HANDLE */
@@ -219,6 +478,68 @@ static int32 Cleanup(LL_HANDLE *llHdl, int32 retCode);
 static void CounterStore(LL_HANDLE *llHdl, int32 ch, int32 cond);
 static void CounterClear(LL_HANDLE *llHdl, int32 ch, int32 cond);
 static void CounterLoad(LL_HANDLE *llHdl, int32 ch, int32 cond);
+static void FifoPut(LL_HANDLE *llHdl, int32 ch, u_int32 value, u_int32 cause,
+					M72_CNT64 *time);
+static void EvRingPut(LL_HANDLE *llHdl, int32 ch, u_int32 value, u_int32 cause,
+					  M72_CNT64 *time);
+static int32 FifoRead(LL_HANDLE *llHdl, int32 ch, M72_FIFO_ENTRY *buf,
+					  int32 size, int32 *nbrRdBytesP);
+static int32 FifoGet(LL_HANDLE *llHdl, int32 ch, M72_FIFO_ENTRY *entry);
+static void MeasStart(LL_HANDLE *llHdl, int32 ch);
+static void Ext64Wrap(LL_HANDLE *llHdl, int32 ch);
+static void Ext64Enable(LL_HANDLE *llHdl, int32 ch, u_int32 enable);
+static void Ext64Read(LL_HANDLE *llHdl, int32 ch, M72_CNT64 *cnt);
+static void Ext64Latch(LL_HANDLE *llHdl, int32 ch, M72_CNT64 *cnt);
+static void EvQueuePut(LL_HANDLE *llHdl, int32 ch, u_int32 value, u_int32 cause,
+					   M72_CNT64 *time);
+static int32 EvQueueRead(LL_HANDLE *llHdl, int32 ch, M72_EVENT *buf,
+						 int32 size, int32 *nbrRdBytesP);
+static int32 SetStatList(LL_HANDLE *llHdl, M72_SETSTAT_ENTRY *list, u_int32 nbr);
+static int32 SetStatListCheck(LL_HANDLE *llHdl, M72_SETSTAT_ENTRY *entry);
+static void ConfigGet(LL_HANDLE *llHdl, M72_CONFIG *cfg);
+static int32 CamLoad(LL_HANDLE *llHdl, int32 ch, M72_CAM *tbl, u_int32 size);
+static int32 SeqLoad(LL_HANDLE *llHdl, int32 ch, M72_SEQ *seq, u_int32 size);
+static int32 CamSet(LL_HANDLE *llHdl, int32 ch, u_int32 mode, u_int32 loop,
+					u_int32 incr, u_int32 count, u_int32 *table);
+static void CamNext(LL_HANDLE *llHdl, int32 ch);
+static void IrqEnbMask(LL_HANDLE *llHdl);
+static void IrqActMask(LL_HANDLE *llHdl);
+static int32 PretrigEnable(LL_HANDLE *llHdl, int32 enable);
+static void PretrigStop(LL_HANDLE *llHdl);
+static u_int32 PretrigIrq(LL_HANDLE *llHdl, u_int32 irqState);
+static void PretrigSetup(LL_HANDLE *llHdl);
+static u_int32 PretrigFrac(u_int32 cnt, u_int32 frac);
+static void PretrigStatPut(LL_HANDLE *llHdl, u_int32 cnt);
+static u_int32 PretrigPredict(LL_HANDLE *llHdl, u_int32 cnt);
+static void PretrigPredReset(LL_HANDLE *llHdl, u_int32 cnt);
+static int32 PretrigRsh(int32 d, u_int32 k);
+static void PretrigLatComp(LL_HANDLE *llHdl, u_int32 set, u_int32 clr);
+static void PretrigStatClear(LL_HANDLE *llHdl);
+static void PretrigStatGet(LL_HANDLE *llHdl, M72_PRETRIG_STAT *stat);
+static u_int32 Div64(u_int32 high, u_int32 low, u_int32 div);
+static void IrqWork(LL_HANDLE *llHdl, IRQ_WORK *work, u_int32 lock);
+static u_int32 IrqStore(LL_HANDLE *llHdl, u_int32 ch, u_int32 cause,
+						u_int32 store, u_int32 value, M72_CNT64 *stamp);
+static void IrqWake(LL_HANDLE *llHdl, u_int32 ch, u_int32 cause,
+					u_int32 store);
+static void IrqDefer(void *arg);
+static IRQ_WORK *DeferNext(LL_HANDLE *llHdl);
+static void DeferPut(LL_HANDLE *llHdl, IRQ_WORK *work);
+static int32 DeferSet(LL_HANDLE *llHdl, u_int32 period);
+#ifdef M72_IRQ_PROFILE
+static u_int32 ProfTime(LL_HANDLE *llHdl);
+static u_int32 ProfBin(u_int32 val);
+static void ProfGet(LL_HANDLE *llHdl, M72_ISR_PROFILE *prof);
+#endif
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+/* de Bruijn sequence bit index table (see FIRST_BIT) */
+static const u_int8 G_firstBit[32] = {
+	 0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+	31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+};
 
 /**************************** M72_GetEntry *********************************
  *
@@ -280,8 +601,24 @@ static void CounterLoad(LL_HANDLE *llHdl, int32 ch, int32 cond);
  *                DEBUG_LEVEL            OSS_DBG_DEFAULT  see dbg.h
  *                ID_CHECK               1                0..1 
  *                PLD_LOAD               1                0..1 
+ *                PLD_VARIANT            0                0..1
  *                OUT_MODE               0                0..max
  *                OUT_SET                0                0..0xf
+ *                EVRING_SIZE            0                0,2^n..0x10000
+ *                EVQUEUE_DEPTH          0                0..0x10000
+ *                IRQ_DEFER              0                0..1000
+ *                PRETRIG_ENABLE         0                0..1
+ *                PRETRIG_OFFSET         25               25..max
+ *                PRETRIG_PERIOD         0                0..3
+ *                PRETRIG_SET            1                0..3
+ *                PRETRIG_CLR            2                0..3
+ *                PRETRIG_FSET           0x10000          0..0x10000
+ *                PRETRIG_FCLR           0x8000           0..0x10000
+ *                PRETRIG_OUT            4                1..4
+ *                PRETRIG_PRED           0                0..3
+ *                PRETRIG_PRED_K         2                0..4
+ *                PRETRIG_BAND           0                0..0x10000
+ *                PRETRIG_LATCOMP        0                0..1
  *                CHANNEL_n/CNT_MODE     0                0..7,9,10  (1)
  *                CHANNEL_n/CNT_PRELOAD  0                0..3    
  *                CHANNEL_n/CNT_CLEAR    0                0..3    
@@ -294,25 +631,57 @@ static void CounterLoad(LL_HANDLE *llHdl, int32 ch, int32 cond);
  *                CHANNEL_n/VAL_PRELOAD  0                0..max
  *                CHANNEL_n/VAL_COMPA    0                0..max
  *                CHANNEL_n/VAL_COMPB    0                0..max
- *                CHANNEL_n/READ_MODE    2                0..2  
+ *                CHANNEL_n/READ_MODE    2                0..3    (3)
  *                CHANNEL_n/READ_TIMEOUT 0xffffffff       0..0xffffffff ms
  *                CHANNEL_n/WRITE_MODE   2                0, 2    (2)
  *                CHANNEL_n/TIMER_START  0                0..1
+ *                CHANNEL_n/BLKREAD_MODE 0                0..2
+ *                CHANNEL_n/FIFO_DEPTH   0                0..0x10000
+ *                CHANNEL_n/FIFO_EVENTS  0x13             0..0x1f
  *
  *                (1) value 8 is not valid.
  *                (2) only values 0 and 2 are used for write mode.
+ *                (3) value 3 requires FIFO_DEPTH > 0.
  *
  *
  *                PLD_LOAD defines if the PLD is loaded at M72_Init.
  *                With PLD_LOAD disabled, ID_CHECK is implicitly disabled.
  *                (This key is for test purposes and should always be set to 1.)
  *
+ *                PLD_VARIANT selects the PLD image: 0 = standard (-00),
+ *                1 = pretrigger variant (-01), which additionally routes
+ *                OUT_4 and AIN2+ to the M-Module interface pins TRIG_A and
+ *                TRIG_B. The pretrigger mode works with both images.
+ *
  *                OUT_MODE defines the output signal mode.
  *                (see SetStat: M72_OUT_MODE)
  *
  *                OUT_SET defines the output signal setting.
  *                (see SetStat: M72_OUT_SET)
  *
+ *                EVRING_SIZE defines the number of records of the event
+ *                ring (power of 2). The ring is allocated here. 0 disables
+ *                the ring. (see GetStat: M72_BLK_EVRING, M72_EVRING_ADDR)
+ *
+ *                EVQUEUE_DEPTH defines the number of entries of the event
+ *                queue, which collects the events of all channels. The queue
+ *                is allocated here. 0 disables the queue.
+ *                (see M72_BlockRead: M72_BLKREAD_EVQUEUE)
+ *
+ *                IRQ_DEFER defines the period [ms] of the deferred
+ *                interrupt work, max. 1000. 0 executes all work in the
+ *                interrupt service routine. (see SetStat: M72_IRQ_DEFER)
+ *
+ *                PRETRIG_ENABLE enables the pretrigger mode at the end of
+ *                M72_Init. (see SetStat: M72_EN_PRETRIG)
+ *
+ *                PRETRIG_OFFSET defines the pretrigger offset.
+ *                (see SetStat: M72_CNT_PRETRIG)
+ *
+ *                PRETRIG_xxx define the pretrigger channels, edge fractions,
+ *                output line, predictor and latency compensation.
+ *                (see SetStat: M72_PRETRIG_xxx)
+ *
  *                CNT_MODE defines the counter mode of channel n.
  *                (see M72_SetStat: M72_CNT_MODE)
  *                    NOTE: Value 8 is not a valid counter mode!
@@ -363,6 +732,19 @@ static void CounterLoad(LL_HANDLE *llHdl, int32 ch, int32 cond);
  *
  *                TIMER_START defines the timer start condition of channel n.
  *
+ *                BLKREAD_MODE defines the mode of block read calls of
+ *                channel n.
+ *                (see SetStat: M72_BLKREAD_MODE)
+ *
+ *                FIFO_DEPTH defines the number of entries of the event FIFO
+ *                of channel n. The FIFO is allocated here. 0 disables the
+ *                FIFO.
+ *
+ *                FIFO_EVENTS defines the interrupt events of channel n
+ *                which store the counter latch in the FIFO, event ring and
+ *                event queue.
+ *                (see SetStat: M72_FIFO_EVENTS)
+ *
  *---------------------------------------------------------------------------
  *  Input......:  descSpec   pointer to descriptor data
  *                osHdl      oss handle
@@ -383,7 +765,8 @@ static int32 M72_Init(
 )
 {
     LL_HANDLE *llHdl = NULL;
-    u_int32 gotsize, value, loadPld, outMode, outSet, n;
+    u_int32 gotsize, value, loadPld, pldVariant, outMode, outSet, evRingSize, n;
+    u_int32 ptEnable, deferPeriod;
 	u_int16 irq_statex;
     int32 error;
 	u_int16 modIdMagic; 
@@ -405,6 +788,7 @@ static int32 M72_Init(
     llHdl->osHdl      = osHdl;
     llHdl->irqHdl     = irqHdl;
     llHdl->ma		  = *ma;
+    llHdl->tbChan     = M72_TIMEBASE_OFF;
 
     /*------------------------------+
     |  create semaphores            |
@@ -415,6 +799,10 @@ static int32 M72_Init(
 			return( Cleanup(llHdl,error) );
 	}
 
+	if ((error = OSS_SemCreate(llHdl->osHdl, OSS_SEM_BIN, 0,
+							   &llHdl->evq.semHdl)))
+		return( Cleanup(llHdl,error) );
+
     /*------------------------------+
     |  prepare debugging            |
     +------------------------------*/
@@ -459,6 +847,15 @@ static int32 M72_Init(
 	if (loadPld == FALSE)
 		llHdl->idCheck = FALSE;
 
+    /* PLD_VARIANT */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&pldVariant, "PLD_VARIANT")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (pldVariant > 1)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
     /* OUT_MODE */
     if ((error = DESC_GetUInt32(llHdl->descHdl, 0x0, 
 								&outMode, "OUT_MODE")) &&
@@ -474,6 +871,128 @@ static int32 M72_Init(
 	if (outSet > 0xf)
 		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
 
+    /* EVRING_SIZE */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&evRingSize, "EVRING_SIZE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if ((evRingSize > EVRING_SIZE_MAX) || (evRingSize & (evRingSize - 1)))
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* EVQUEUE_DEPTH */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->evq.depth, "EVQUEUE_DEPTH")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->evq.depth > EVQUEUE_DEPTH_MAX)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* IRQ_DEFER */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&deferPeriod, "IRQ_DEFER")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (deferPeriod > DEFER_PERIOD_MAX)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* PRETRIG_ENABLE */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, FALSE,
+								&ptEnable, "PRETRIG_ENABLE")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* PRETRIG_OFFSET */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_OFFSET,
+								&llHdl->cntPretrig, "PRETRIG_OFFSET")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (ptEnable > 1 || llHdl->cntPretrig < PRETR_OFFSET)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* PRETRIG_PERIOD */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_TIMER_A,
+								&llHdl->ptPeriod, "PRETRIG_PERIOD")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* PRETRIG_SET */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_TIMER_B,
+								&llHdl->ptSet, "PRETRIG_SET")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* PRETRIG_CLR */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_TIMER_C,
+								&llHdl->ptClr, "PRETRIG_CLR")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->ptPeriod >= CH_NUMBER || llHdl->ptSet >= CH_NUMBER ||
+		llHdl->ptClr >= CH_NUMBER)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* PRETRIG_FSET */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_FRAC_B,
+								&llHdl->ptFracSet, "PRETRIG_FSET")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* PRETRIG_FCLR */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_FRAC_C,
+								&llHdl->ptFracClr, "PRETRIG_FCLR")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->ptFracSet > M72_PRETRIG_FRAC_ONE ||
+		llHdl->ptFracClr > M72_PRETRIG_FRAC_ONE)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* PRETRIG_OUT */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_OUT,
+								&llHdl->ptOut, "PRETRIG_OUT")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (!IN_RANGE(llHdl->ptOut,1,4))
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+    /* PRETRIG_PRED */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_PRED,
+								&llHdl->ptPredMode, "PRETRIG_PRED")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* PRETRIG_PRED_K */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, PRETR_PRED_K,
+								&llHdl->ptPredK, "PRETRIG_PRED_K")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* PRETRIG_BAND */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->ptBand, "PRETRIG_BAND")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+    /* PRETRIG_LATCOMP */
+    if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+								&llHdl->ptLatComp, "PRETRIG_LATCOMP")) &&
+		error != ERR_DESC_KEY_NOTFOUND)
+		return( Cleanup(llHdl,error) );
+
+	if (llHdl->ptPredMode > M72_PRED_TREND ||
+		llHdl->ptPredK > M72_PRED_K_MAX ||
+		llHdl->ptBand > M72_PRETRIG_FRAC_ONE ||
+		llHdl->ptLatComp > 1)
+		return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+	llHdl->ptStat.histShift = PRETR_HSHIFT;
+	PretrigStatClear(llHdl);
+
 	/* channel 0..3 params */
 	for (n=0; n<CH_NUMBER; n++) {
 		/* CNT_MODE */
@@ -594,7 +1113,7 @@ static int32 M72_Init(
 			error != ERR_DESC_KEY_NOTFOUND)
 			return( Cleanup(llHdl,error) );
 
-		if (llHdl->readMode[n] > 2)									
+		if (llHdl->readMode[n] > 3)
 			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
 
         /* READ_TIMEOUT */
@@ -623,6 +1142,85 @@ static int32 M72_Init(
 
 		if (llHdl->timerStart[n] > 1)
 			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+        /* BLKREAD_MODE */
+		if ((error = DESC_GetUInt32(llHdl->descHdl, M72_BLKREAD_SNAPSHOT,
+									&llHdl->blkReadMode[n],
+									"CHANNEL_%d/BLKREAD_MODE", n)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		if (llHdl->blkReadMode[n] > 2)
+			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+        /* FIFO_DEPTH */
+		if ((error = DESC_GetUInt32(llHdl->descHdl, 0,
+									&llHdl->fifo[n].depth,
+									"CHANNEL_%d/FIFO_DEPTH", n)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		if (llHdl->fifo[n].depth > FIFO_DEPTH_MAX)
+			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+		if (llHdl->readMode[n] == M72_READ_QUEUE && llHdl->fifo[n].depth == 0)
+			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+
+        /* FIFO_EVENTS */
+		if ((error = DESC_GetUInt32(llHdl->descHdl,
+									M72_INT_READY | M72_INT_COMP | M72_INT_XIN2,
+									&llHdl->fifo[n].events,
+									"CHANNEL_%d/FIFO_EVENTS", n)) &&
+			error != ERR_DESC_KEY_NOTFOUND)
+			return( Cleanup(llHdl,error) );
+
+		if (llHdl->fifo[n].events > CHAN_PEND_MASK)
+			return( Cleanup(llHdl,ERR_LL_ILL_PARAM) );
+	}
+
+    /*------------------------------+
+    |  alloc FIFOs                  |
+    +------------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->fifo[n].depth == 0)
+			continue;
+
+		if ((llHdl->fifo[n].buf = (M72_FIFO_ENTRY*)
+			 OSS_MemGet(osHdl, llHdl->fifo[n].depth * sizeof(M72_FIFO_ENTRY),
+						&llHdl->fifo[n].bufSize)) == NULL)
+			return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+
+		DBGWRT_2((DBH, " channel %d: FIFO depth=%d\n",
+				  n, llHdl->fifo[n].depth));
+	}
+
+    /*------------------------------+
+    |  alloc event ring             |
+    +------------------------------*/
+	if (evRingSize) {
+		if ((llHdl->evRing = (M72_EVRING*)
+			 OSS_MemGet(osHdl, M72_EVRING_SIZE(evRingSize),
+						&llHdl->evRingAlloc)) == NULL)
+			return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+
+		OSS_MemFill(osHdl, llHdl->evRingAlloc, (char*)llHdl->evRing, 0x00);
+		llHdl->evRingMask    = evRingSize - 1;
+		llHdl->evRing->size  = evRingSize;
+		llHdl->evRing->magic = M72_EVRING_MAGIC;
+
+		DBGWRT_2((DBH, " event ring: size=%d\n", llHdl->evRing->size));
+	}
+
+    /*------------------------------+
+    |  alloc event queue            |
+    +------------------------------*/
+	if (llHdl->evq.depth) {
+		if ((llHdl->evq.buf = (M72_EVENT*)
+			 OSS_MemGet(osHdl, llHdl->evq.depth * sizeof(M72_EVENT),
+						&llHdl->evq.bufSize)) == NULL)
+			return( Cleanup(llHdl,ERR_OSS_MEM_ALLOC) );
+
+		DBGWRT_2((DBH, " event queue: depth=%d\n", llHdl->evq.depth));
 	}
 
     /*---------------------------+
@@ -728,7 +1326,8 @@ static int32 M72_Init(
     +------------------------------*/
 	/* driver's ident function */
 	llHdl->idFuncTbl.idCall[0].identCall = Ident;
-	llHdl->idFuncTbl.idCall[1].identCall = __M72_PldIdent;
+	llHdl->idFuncTbl.idCall[1].identCall =
+		pldVariant ? __M72_PldIdent01 : __M72_PldIdent;
 	/* library's ident functions */
 	llHdl->idFuncTbl.idCall[2].identCall = DESC_Ident;
 	llHdl->idFuncTbl.idCall[3].identCall = OSS_Ident;
@@ -742,7 +1341,8 @@ static int32 M72_Init(
 	if (loadPld) {
 	    MACCESS   maPld;
 		u_int32 size;
-		u_int8  *dataP = (u_int8*)__M72_PldData; 			/* point to binary data */
+		u_int8  *dataP = (u_int8*)(pldVariant ? __M72_PldData01 :
+											__M72_PldData);	/* point to binary data */
 
 		MACCESS_CLONE(llHdl->ma, maPld, PLD_IF_REG);	/* create access handle */
 
@@ -769,6 +1369,7 @@ static int32 M72_Init(
     |  (registers and shadow array) |
     +------------------------------*/
 	llHdl->irqCount = 0;					
+	llHdl->irqReject = 0;
 	/* clear pending irqs in irq state register 1*/
 	if( (irq_statex = MREAD_D16(llHdl->ma, IRQ_STATE_REG1)) )
 		MWRITE_D16(llHdl->ma, IRQ_STATE_REG1, irq_statex);
@@ -816,6 +1417,8 @@ static int32 M72_Init(
 
 		MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(n), llHdl->regIrqCtrl[n]);
 	}
+	IrqEnbMask(llHdl);
+	IrqActMask(llHdl);
 
 	/* output setting */
 	MWRITE_D16(llHdl->ma, OUT_CONFIG_REG, (u_int16)(outSet));
@@ -830,6 +1433,14 @@ static int32 M72_Init(
 	llHdl->regSelftest = 0x0000;
 	MWRITE_D16(llHdl->ma, SELFTEST_REG, llHdl->regSelftest);
 
+	/* pretrigger mode */
+	if (ptEnable && (error = PretrigEnable(llHdl, TRUE)))
+		return( Cleanup(llHdl,error) );
+
+	/* deferred irq work */
+	if (deferPeriod && (error = DeferSet(llHdl, deferPeriod)))
+		return( Cleanup(llHdl,error) );
+
 	return(ERR_SUCCESS);
 }
 
@@ -919,6 +1530,16 @@ static int32 M72_Exit(
  *                Then the function reads the latched counter of the current
  *                channel as a 32-bit value.
  *
+ *                With read mode M72_READ_QUEUE, the function returns the
+ *                oldest value of the channel's FIFO instead, i.e. the
+ *                counter latch captured by the interrupt service routine at
+ *                the Ready interrupt (and the other configured FIFO events,
+ *                see M72_SetStat: M72_FIFO_EVENTS). If the FIFO is empty, the
+ *                function waits for a value or timeout. Values are returned
+ *                in order; lost values are counted (M72_FIFO_OVERRUN) and
+ *                the sequence number of the returned value can be queried
+ *                (M72_READ_SEQ).
+ *
  *                See also: Counter latch condition (M72_CNT_STORE setstat) 
  *
  *---------------------------------------------------------------------------
@@ -937,9 +1558,31 @@ static int32 M72_Read(
 	u_int32 low_word, high_word;
 	int32 error;
 	OSS_IRQ_STATE oldState;
+	M72_FIFO_ENTRY entry;
 
     DBGWRT_1((DBH, "LL - M72_Read: ch=%d:\n",ch));
 
+	/*----------------------------+ 
+	|  read queued value          |
+	+----------------------------*/
+	if (llHdl->readMode[ch] == M72_READ_QUEUE) {
+		while (!FifoGet(llHdl, ch, &entry)) {
+			DBGWRT_2((DBH, " wait for queued value ..\n"));
+
+			if ((error = OSS_SemWait(llHdl->osHdl, llHdl->readSemHdl[ch],
+									 llHdl->readTimeout[ch])))
+				return(error);
+		}
+
+		llHdl->fifo[ch].readSeq = entry.seq;
+		*value = entry.value;
+
+		DBGWRT_2((DBH, " read queued value=0x%08x seq=%d\n",
+				  *value, entry.seq));
+
+		return(ERR_SUCCESS);
+	}
+
 	/*----------------------------+ 
 	|  wait for Ready irq         |
 	+----------------------------*/
@@ -962,9 +1605,16 @@ static int32 M72_Read(
 	+----------------------------*/
 	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
 
-	low_word  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(ch));
-	high_word = MREAD_D16(llHdl->ma, COUNT_HIGH_REG(ch));
-	*value = low_word | (high_word << 16);
+	/* period timer: latch overwritten by PretrigLatComp */
+	if (llHdl->ptActive && (u_int32)ch == llHdl->ptPeriod &&
+		llHdl->readMode[ch] != M72_READ_NOW) {
+		*value = llHdl->ptLatch;
+	}
+	else {
+		low_word  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(ch));
+		high_word = MREAD_D16(llHdl->ma, COUNT_HIGH_REG(ch));
+		*value = low_word | (high_word << 16);
+	}
 
 	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
 
@@ -1011,6 +1661,7 @@ static int32 M72_Write(
 	+----------------------------*/
     DBGWRT_2((DBH, " write preload=0x%08x\n",value));
 
+	llHdl->valPreload[ch] = value;
 	MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(ch),  (u_int16)(value & 0xffff));
 	MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(ch), (u_int16)(value >> 16));
 
@@ -1046,13 +1697,27 @@ static int32 M72_Write(
  *                M72_LBREAK_IRQ  	   Line-Break   irq enable    0..1
  *                M72_XIN2_IRQ   	   xIN2 Edge    irq enable    0..1
  *                M72_INT_STATUS       irq status bits            0..0x1f
+ *                M72_IRQ_REJECT       rejected interrupts        0..max
+ *                M72_IRQ_DEFER        deferred irq work [ms]     0..1000
+ *                M72_DEFER_OVERRUN    dropped deferred irqs      0..max
+ *                M72_PROFILE_CLEAR    clear ISR profile          -
  *                M72_VAL_COMPA        comparator A value         0..max
  *                M72_VAL_COMPB        comparator B value         0..max
- *                M72_READ_MODE        mode for read calls        0..2
+ *                M72_READ_MODE        mode for read calls        0..3
  *                M72_READ_TIMEOUT     timeout for read calls     0..0xffffffff
  *                M72_WRITE_MODE       mode for write calls       0, 2    (1)
  *                M72_TIMER_START      timer start condition      0..1
  *                M72_FREQ_START       start frequency measurem.  -
+ *                M72_CONTINUOUS       continuous measurement     0..1
+ *                M72_EXT64            64-bit counter extension   0..1
+ *                M72_TIMEBASE         timebase channel           0..3, (4)
+ *                M72_CAPTURE          xIN2 capture mode          0..1
+ *                M72_BLKREAD_MODE     mode for block read calls  0..2
+ *                M72_FIFO_EVENTS      irq events stored in FIFO  0..0x1f
+ *                M72_FIFO_OVERRUN     lost FIFO entries          0..max
+ *                M72_FIFO_CLEAR       flush FIFO                 -
+ *                M72_EVQUEUE_OVERRUN  lost event queue entries   0..max
+ *                M72_EVQUEUE_CLEAR    flush event queue          -
  *                M72_SIGSET_READY     install Ready        sig.  1..max
  *                M72_SIGSET_COMP      install Comparator   sig.  1..max
  *                M72_SIGSET_CYBW      install Carry/Borrow sig.  1..max
@@ -1066,6 +1731,25 @@ static int32 M72_Write(
  *                M72_OUT_MODE         output signal mode           (2)
  *                M72_OUT_SET          output signal setting      0..0xf
  *                M72_SELFTEST         self-test register      no statements (3)
+ *                M72_BLK_SETSTAT_LIST list of setstats           -
+ *                M72_BLK_CAM          comparator cam table       -
+ *                M72_BLK_SEQ          timer interval sequence    -
+ *                M72_SEQ_UNDERRUN     late sequence intervals    0..max
+ *                M72_CNT_PRETRIG      pretrigger offset [ticks]  25..max
+ *                M72_EN_PRETRIG       enable pretrigger          0..1
+ *                M72_PRETRIG_PERIOD   period timer channel       0..3
+ *                M72_PRETRIG_SET      set edge timer channel     0..3
+ *                M72_PRETRIG_CLR      clear edge timer channel   0..3
+ *                M72_PRETRIG_FSET     set edge period fraction   0..0x10000
+ *                M72_PRETRIG_FCLR     clear edge period fraction 0..0x10000
+ *                M72_PRETRIG_OUT      pretrigger output line     1..4
+ *                M72_PRETRIG_HBASE    histogram bin 0 bound      0..max
+ *                M72_PRETRIG_HSHIFT   histogram bin width        0..31
+ *                M72_PRETRIG_SCLEAR   clear period statistics    -
+ *                M72_PRETRIG_PRED     period predictor           0..3
+ *                M72_PRETRIG_PRED_K   predictor window/gain      0..4
+ *                M72_PRETRIG_BAND     outlier band               0..0x10000
+ *                M72_PRETRIG_LATCOMP  latency compensation       0..1
  *                -------------------  -------------------------  ----------
  *                Note: for values see also m72_drv.h
  *
@@ -1074,6 +1758,7 @@ static int32 M72_Write(
  *                (3) the M72 M-Module supports factory self tests. These tests
  *                    are controlled through the Self-test Register. 
  *                    !! THE USER SHOULD NEVER PROGRAM THE SELF-TEST REGISTER !!
+ *                (4) or M72_TIMEBASE_OFF
  *
  *
  *                M72_CNT_MODE defines the counter mode of the current channel:
@@ -1193,6 +1878,48 @@ static int32 M72_Write(
  *                          might not be detected.
  *
  *
+ *                M72_IRQ_REJECT sets the counter of rejected interrupts, i.e.
+ *                interrupts not caused by an enabled channel (e.g. from
+ *                another device on a shared interrupt line).
+ *
+ *
+ *                M72_IRQ_DEFER enables the deferred interrupt work with the
+ *                specified period [ms] (see also descriptor key IRQ_DEFER).
+ *                0 disables it, i.e. all work is done in the interrupt
+ *                service routine (default).
+ *                In deferred mode, the interrupt service routine only
+ *                acknowledges the interrupt, does the hardware related work
+ *                (counter latch, cam/sequence, continuous measurement,
+ *                Line-Break disable, 64-bit extension, pretrigger) and
+ *                queues the pending flags. A cyclic alarm stores the events
+ *                (FIFO, event ring, event queue, M72_TIME_xxx), releases the
+ *                read semaphores and sends the signals in the order of the
+ *                interrupts.
+ *
+ *                    NOTE: Signals and the wake-up of reads are delayed by
+ *                          up to one period. The alarm runs cyclically
+ *                          as long as the deferred mode is enabled, also
+ *                          when no interrupt occurs.
+ *                          When the queue (64 entries) is full, an
+ *                          interrupt is merged into the last entry for the
+ *                          channels without pending flags there. The part
+ *                          of the other channels is dropped and
+ *                          M72_DEFER_OVERRUN is incremented: its counter
+ *                          values are counted as lost (M72_FIFO_OVERRUN,
+ *                          M72_EVQUEUE_OVERRUN, gaps in the sequence
+ *                          numbers), its signals, read wake-ups and
+ *                          M72_TIME_xxx updates are lost.
+ *
+ *
+ *                M72_DEFER_OVERRUN sets the counter of interrupts (partly)
+ *                dropped by the full deferred work queue.
+ *
+ *
+ *                M72_PROFILE_CLEAR clears the ISR profile (see M72_GetStat:
+ *                M72_BLK_IRQ_PROFILE). Only supported if the driver was
+ *                built with M72_IRQ_PROFILE.
+ *
+ *
  *                M72_VAL_COMPA/B loads the comparator A/B with a 32-bit value.
  *
  *
@@ -1203,11 +1930,18 @@ static int32 M72_Write(
  *                    M72_READ_LATCH    0x00    read latched value
  *                    M72_READ_WAIT		0x01	wait for Ready irq
  *                    M72_READ_NOW		0x02	force counter latch
+ *                    M72_READ_QUEUE    0x03    read queued values (FIFO)
  *
  *                    NOTE: For mode M72_READ_WAIT the interrupt must be enabled 
  *                          for the respective channel (IRQEN must be set in the
  *                          Interrupt Control Register).
  *
+ *                    NOTE: Mode M72_READ_QUEUE requires a FIFO for the
+ *                          channel (see descriptor key FIFO_DEPTH), otherwise
+ *                          ERR_LL_ILL_PARAM is returned. In this mode, the
+ *                          Ready event is always stored in the FIFO.
+ *                          (see M72_Read)
+ *
  *
  *                M72_READ_TIMEOUT defines a timeout in milliseconds for read
  *                calls of the current channel, when waiting for a Ready
@@ -1235,6 +1969,130 @@ static int32 M72_Write(
  *                ERR_LL_ILL_PARAM is returned for all other counter modes.
  *
  *
+ *                M72_CONTINUOUS enables/disables the continuous measurement
+ *                of the current channel (for the frequency, period and
+ *                pulse width meas. modes). If enabled, the first
+ *                measurement is started immediately. At each Ready
+ *                interrupt, the interrupt service routine stores the result
+ *                with a timestamp in the channel's FIFO and restarts the
+ *                measurement:
+ *
+ *                    M72_MODE_FREQ     restart gate timer, i.e. the gates
+ *                                      follow back to back
+ *                    M72_MODE_PERIOD   force counter clear
+ *                    M72_MODE_PULSEH   force counter clear
+ *                    M72_MODE_PULSEL   force counter clear
+ *
+ *                The results are read with M72_Read (read mode
+ *                M72_READ_QUEUE) or, many at once, with M72_BlockRead
+ *                (block read mode M72_BLKREAD_FIFO).
+ *
+ *                    NOTE: The interrupt must be enabled for the channel
+ *                          (see M72_ENB_IRQ). A FIFO must be allocated (see
+ *                          descriptor key FIFO_DEPTH), otherwise
+ *                          ERR_LL_ILL_PARAM is returned. Changing the
+ *                          counter mode stops the continuous measurement.
+ *
+ *
+ *                M72_EXT64 enables/disables the 64-bit extension of the
+ *                counter of the current channel. Enabling clears the upper
+ *                32 bits and sets the carry/borrow interrupt condition to
+ *                M72_CYBW_CYBW. At each Carry/Borrow interrupt, the
+ *                interrupt service routine latches the counter and
+ *                increments (carry: bit 31 clear) or decrements (borrow:
+ *                bit 31 set) the upper 32 bits. The 64-bit counter is read
+ *                with the M72_BLK_CNT64 getstat.
+ *
+ *                    NOTE: The interrupt must be enabled for the channel
+ *                          (see M72_ENB_IRQ). The driver uses the counter
+ *                          latch, i.e. the counter store condition should
+ *                          be M72_STORE_NO. The counter must not be
+ *                          preloaded/cleared at carry or borrow.
+ *                          ERR_LL_ILL_PARAM is returned if the capture mode
+ *                          of the channel is enabled (see M72_CAPTURE).
+ *
+ *
+ *                M72_TIMEBASE selects a channel as hardware timebase for
+ *                the timestamps of all interrupt events (see M72_GetStat:
+ *                M72_TIME_RATE). The current channel is ignored, the value
+ *                is the timebase channel. The channel must be in timer mode
+ *                (M72_MODE_TIMER, counting up, never cleared or preloaded)
+ *                and its interrupt must be enabled (see M72_ENB_IRQ),
+ *                otherwise ERR_LL_ILL_PARAM is returned. The 64-bit
+ *                extension of the channel is enabled (see M72_EXT64). The
+ *                interrupt service routine latches the channel at each
+ *                interrupt, i.e. the timestamps have a resolution of 0.4us
+ *                (2.5MHz).
+ *                Changing the counter mode of the channel, disabling its
+ *                interrupt or M72_TIMEBASE_OFF (default) switches back to
+ *                OS timestamps.
+ *
+ *
+ *                M72_CAPTURE enables/disables the xIN2 capture mode of the
+ *                current channel. Enabling sets the counter store condition
+ *                to M72_STORE_IN2 and enables the xIN2 Edge interrupt. At
+ *                each xIN2 Edge interrupt, the interrupt service routine
+ *                reads the counter latch and stores it with a timestamp in
+ *                the channel's FIFO (only xIN2 events, M72_FIFO_EVENTS is
+ *                ignored). The captured values are read with M72_Read
+ *                (read mode M72_READ_QUEUE) or, many at once, with
+ *                M72_BlockRead (block read mode M72_BLKREAD_FIFO).
+ *
+ *                    NOTE: The interrupt must be enabled for the channel
+ *                          (see M72_ENB_IRQ). A FIFO must be allocated (see
+ *                          descriptor key FIFO_DEPTH) and the 64-bit
+ *                          extension must be disabled (see M72_EXT64, also
+ *                          used by M72_TIMEBASE), otherwise
+ *                          ERR_LL_ILL_PARAM is returned. Changing the
+ *                          counter store condition or disabling the xIN2
+ *                          Edge interrupt stops the capture mode. The
+ *                          hardware latches one value per xIN2 edge,
+ *                          edges following faster than the interrupt
+ *                          latency overwrite the latch.
+ *
+ *
+ *                M72_BLKREAD_MODE defines the mode for block read calls of
+ *                the current channel:
+ *
+ *                    M72_BLKREAD_SNAPSHOT 0x00 snapshot of all channels
+ *                    M72_BLKREAD_FIFO     0x01 drain FIFO of current channel
+ *                    M72_BLKREAD_EVQUEUE  0x02 wait for/drain event queue
+ *
+ *                    (see M72_BlockRead)
+ *
+ *
+ *                M72_FIFO_EVENTS defines the interrupt events of the current
+ *                channel which store the counter latch in the channel's
+ *                FIFO (see descriptor key FIFO_DEPTH), in the event ring
+ *                (see descriptor key EVRING_SIZE) and in the event queue
+ *                (see descriptor key EVQUEUE_DEPTH). The flags can be ORed:
+ *
+ *                    M72_INT_READY      0x01   Ready
+ *                    M72_INT_COMP       0x02   Comparator
+ *                    M72_INT_CYBW       0x04   Carry/Borrow
+ *                    M72_INT_LBREAK     0x08   Line-Break
+ *                    M72_INT_XIN2       0x10   xIN2 Edge
+ *
+ *                    NOTE: The counter latch is read as is. Configure the
+ *                          counter store condition accordingly.
+ *
+ *
+ *                M72_FIFO_OVERRUN sets the counter of FIFO entries of the
+ *                current channel which were lost due to a full FIFO.
+ *
+ *
+ *                M72_FIFO_CLEAR flushes the FIFO of the current channel.
+ *                The sequence numbers are not reset.
+ *
+ *
+ *                M72_EVQUEUE_OVERRUN sets the counter of event queue
+ *                entries which were lost due to a full queue.
+ *
+ *
+ *                M72_EVQUEUE_CLEAR flushes the event queue.
+ *                The sequence numbers are not reset.
+ *
+ *
  *                M72_SIGSET_READY  install Ready              signal    
  *                M72_SIGSET_COMP   install Comparator match   signal    
  *                M72_SIGSET_CYBW   install Carry/Borrow       signal    
@@ -1288,6 +2146,176 @@ static int32 M72_Write(
  *                To affect several output lines, the flags can be logically
  *                combined.
  *
+ *
+ *                M72_BLK_SETSTAT_LIST executes a list of setstats
+ *                (M72_SETSTAT_ENTRY array, see m72_drv.h) as one
+ *                transaction. Each entry specifies the channel, so the
+ *                current channel is ignored.
+ *                First, all entries are checked. If any entry is invalid,
+ *                nothing is changed and ERR_LL_ILL_CHAN, ERR_LL_ILL_PARAM or
+ *                ERR_LL_UNK_CODE is returned.
+ *                Then, with interrupts masked, the entries are applied in
+ *                list order to the driver's shadow registers and each
+ *                modified hardware register is written once. Forced
+ *                actions (M72_CLEAR_NOW, M72_PRELOAD_NOW, M72_STORE_NOW)
+ *                are executed afterwards in this order.
+ *                The following codes are supported:
+ *
+ *                    M72_CNT_MODE, M72_CNT_PRELOAD, M72_CNT_CLEAR,
+ *                    M72_CNT_STORE, M72_TIMER_START, M72_ENB_IRQ,
+ *                    M72_COMP_IRQ, M72_CYBW_IRQ, M72_LBREAK_IRQ,
+ *                    M72_XIN2_IRQ, M72_VAL_COMPA, M72_VAL_COMPB,
+ *                    M72_READ_MODE, M72_READ_TIMEOUT, M72_WRITE_MODE,
+ *                    M72_BLKREAD_MODE, M72_FIFO_EVENTS, M72_OUT_MODE,
+ *                    M72_OUT_SET
+ *
+ *
+ *                M72_BLK_CAM loads a comparator cam table (M72_CAM, see
+ *                m72_drv.h) for the current channel. The first position
+ *                (table[0]) is written to comparator A immediately. At each
+ *                Comparator interrupt, the interrupt service routine writes
+ *                the next position to comparator A:
+ *
+ *                    M72_CAM_OFF   0x00  no cam table (table is removed)
+ *                    M72_CAM_LIST  0x01  next table entry, at the end of
+ *                                        the table restart with table[0]
+ *                                        (loop=1) or stop (loop=0)
+ *                    M72_CAM_INCR  0x02  previous position + incr
+ *
+ *                Together with an output signal mode (see M72_OUT_MODE),
+ *                this generates position synchronous outputs without user
+ *                interaction. Loading a new table replaces the previous
+ *                one. M72_GetStat: M72_CAM_MATCHES returns the number of
+ *                Comparator interrupts since the table was loaded.
+ *                ERR_LL_ILL_PARAM is returned for an invalid mode or count
+ *                (1..0x10000), ERR_LL_USERBUF if the block is smaller than
+ *                M72_CAM_SIZE(count).
+ *
+ *                    NOTE: The interrupt must be enabled for the channel
+ *                          (see M72_ENB_IRQ) and the comparator irq
+ *                          condition must use comparator A (see
+ *                          M72_COMP_IRQ). The next position must be
+ *                          written before the counter reaches it, i.e.
+ *                          the distance of the positions must be longer
+ *                          than the interrupt latency.
+ *
+ *
+ *                M72_BLK_SEQ starts a sequence of timer intervals (M72_SEQ,
+ *                see m72_drv.h) on the current channel, which must be in
+ *                timer mode (M72_MODE_TIMER). The driver sets the counter
+ *                clear condition to M72_CLEAR_COMP and the comparator irq
+ *                condition to M72_COMP_EQUAL, writes the first interval to
+ *                comparator A and clears the counter. At each Comparator
+ *                interrupt (i.e. the counter was cleared), the interrupt
+ *                service routine writes the next interval to comparator A.
+ *                At the end of the sequence, it restarts with interval[0]
+ *                (loop=1) or halts the counter (counter mode M72_MODE_NO,
+ *                loop=0). count=0 stops the sequence.
+ *                Together with an output signal mode (e.g.
+ *                M72_OUT_MODE_TOGLE, see M72_OUT_MODE), this plays back a
+ *                pulse sequence on the outputs without user interaction.
+ *                M72_GetStat: M72_CAM_MATCHES returns the number of
+ *                elapsed intervals.
+ *                ERR_LL_ILL_PARAM is returned for a count > 0x10000 or if
+ *                the channel is not in timer mode, ERR_LL_USERBUF if the
+ *                block is smaller than M72_SEQ_SIZE(count).
+ *
+ *                If the counter already passed the next interval when it
+ *                is written (interrupt latency longer than the interval),
+ *                the interval is restarted by clearing the counter and
+ *                M72_SEQ_UNDERRUN is incremented. M72_SEQ_UNDERRUN can
+ *                be set, e.g. to zero.
+ *
+ *                    NOTE: The interrupt must be enabled for the channel
+ *                          (see M72_ENB_IRQ). The sequence uses comparator
+ *                          A, i.e. it replaces a cam table (see
+ *                          M72_BLK_CAM). Changing the counter mode stops
+ *                          the sequence. The check for late intervals
+ *                          latches the counter (see M72_CNT_STORE).
+ *
+ *
+ *                M72_EN_PRETRIG enables/disables the pretrigger mode (see
+ *                also descriptor key PRETRIG_ENABLE). The channels of the
+ *                pretrigger engine are reconfigured by the driver, the other
+ *                channels keep working as configured. The
+ *                period timer measures the time between two xIN2 edges
+ *                (cleared and latched at xIN2). At each xIN2 interrupt of
+ *                the period timer, the interrupt service routine loads the
+ *                set and clear edge timers (preloaded at xIN2, counting down
+ *                to zero) with
+ *
+ *                    preload = period * fraction / 0x10000 - M72_CNT_PRETRIG
+ *
+ *                The output line is set high when the set edge timer and
+ *                low when the clear edge timer reaches zero, i.e. both
+ *                edges occur M72_CNT_PRETRIG ticks before the predicted
+ *                fraction of the next period.
+ *                The default (Timer A: period, Timer B: set at full period,
+ *                Timer C: clear at half period, OUT4) generates a 50% duty
+ *                cycle signal ahead of the xIN2 edge.
+ *
+ *                M72_PRETRIG_PERIOD/SET/CLR define the channels of the
+ *                period, set edge and clear edge timer. The channels must
+ *                be different, otherwise enabling the pretrigger returns
+ *                ERR_LL_ILL_PARAM.
+ *
+ *                M72_PRETRIG_FSET/FCLR define the fraction of the period for
+ *                the set/clear edge in 1/0x10000 (M72_PRETRIG_FRAC_ONE = full
+ *                period).
+ *
+ *                M72_PRETRIG_OUT defines the output line (Out_1..4).
+ *
+ *                M72_PRETRIG_PRED selects how the next period is predicted
+ *                from the measured periods (k = M72_PRETRIG_PRED_K):
+ *
+ *                    M72_PRED_LAST   0   last period
+ *                    M72_PRED_AVG    1   moving average over 2^k periods
+ *                    M72_PRED_EXP    2   exponential smoothing, gain 1/2^k
+ *                    M72_PRED_TREND  3   linear trend (double exponential
+ *                                        smoothing), gain 1/2^k
+ *
+ *                M72_PRETRIG_BAND defines the outlier band in 1/0x10000 of
+ *                the predicted period (0=off). Periods outside the band are
+ *                not used for the prediction (the preloads are computed
+ *                from the prediction). After 2^k consecutive outliers, the
+ *                predictor restarts from the last period.
+ *
+ *                M72_PRETRIG_LATCOMP enables the latency compensation. The
+ *                edge timers take the preloads written by the interrupt
+ *                service routine at the next xIN2 edge only, i.e. a new
+ *                prediction is applied one period late. With compensation
+ *                enabled, the interrupt service routine latches the period
+ *                timer when writing the preloads (= ticks elapsed since
+ *                the xIN2 edge) and immediately reloads the running edge
+ *                timers with the new preload minus the elapsed ticks. Edges
+ *                which were already reached, or would be, are not touched
+ *                (counted as missed). The latency is always measured (see
+ *                M72_GetStat: M72_BLK_PRETRIG_STAT). The period latch read
+ *                before is kept for the events of the period timer (FIFO,
+ *                event ring/queue) and M72_Read.
+ *
+ *                    NOTE: M72_PRETRIG_xxx can only be changed while the
+ *                          pretrigger engine is stopped, otherwise
+ *                          ERR_LL_ILL_PARAM is returned. Disabling stops
+ *                          the engine at the next xIN2 edge (synchronous
+ *                          output shutdown), disabling again stops it
+ *                          immediately. Enabling overwrites the output
+ *                          signal mode (M72_OUT_MODE) and sets Control_1
+ *                          (M72_OUT_SET) to let the period timer count up.
+ *                          The pretrigger channels must not be changed
+ *                          (counter mode etc.) and must differ from the
+ *                          timebase channel (M72_TIMEBASE), their cam
+ *                          table/sequence and capture mode are stopped.
+ *                          The xIN2 Edge interrupt of the period timer is
+ *                          handled as usual (signal, FIFO etc.).
+ *
+ *                M72_PRETRIG_HBASE/HSHIFT define the period histogram (see
+ *                M72_GetStat: M72_BLK_PRETRIG_STAT). Bin n counts the
+ *                periods from HBASE + n * (1 << HSHIFT) ticks. Changing the
+ *                histogram clears the statistics.
+ *
+ *                M72_PRETRIG_SCLEAR clears the period statistics.
+ *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl             low-level handle
  *                code              status code
@@ -1307,7 +2335,7 @@ static int32 M72_SetStat(
 {
 	int32 error = ERR_SUCCESS;
     int32       value = (int32)value32_or_64;
-    /*INT32_OR_64 valueP = value32_or_64; */
+	M_SG_BLOCK  *blk  = (M_SG_BLOCK*)value32_or_64;
 
     DBGWRT_1((DBH, "LL - M72_SetStat: ch=%d code=0x%04x value=0x%x\n",
 			  ch,code,value));
@@ -1332,6 +2360,39 @@ static int32 M72_SetStat(
             llHdl->irqCount = value;
             break;
         /*--------------------------+
+        |  set irq reject counter   |
+        +--------------------------*/
+        case M72_IRQ_REJECT:
+            llHdl->irqReject = value;
+            break;
+        /*--------------------------+
+        |  deferred irq work        |
+        +--------------------------*/
+        case M72_IRQ_DEFER:
+			if (!IN_RANGE(value,0,DEFER_PERIOD_MAX))
+				return(ERR_LL_ILL_PARAM);
+
+			error = DeferSet(llHdl, value);
+            break;
+        case M72_DEFER_OVERRUN:
+            llHdl->defer.overrun = value;
+            break;
+#ifdef M72_IRQ_PROFILE
+        /*--------------------------+
+        |  clear ISR profile        |
+        +--------------------------*/
+        case M72_PROFILE_CLEAR:
+		{
+			OSS_IRQ_STATE oldState;
+
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			OSS_MemFill(llHdl->osHdl, sizeof(IRQ_PROF),
+						(char*)&llHdl->prof, 0x00);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+			break;
+		}
+#endif
+        /*--------------------------+
         |  channel direction        |
         +--------------------------*/
         case M_LL_CH_DIR:
@@ -1343,17 +2404,32 @@ static int32 M72_SetStat(
         |   counter mode            |
         +--------------------------*/
         case M72_CNT_MODE :
+		{
+			OSS_IRQ_STATE oldState;
+
 			if (!IN_RANGE(value,0,10))
 				return(ERR_LL_ILL_PARAM);
 			
 			if ( value ==8 )
 				return(ERR_LL_ILL_PARAM);
 
+			/* state and shadow register are also changed by M72_Irq */
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
 			llHdl->cntMode[ch] = value;
+			llHdl->continuous[ch] = FALSE;
+			if (llHdl->cam[ch].mode == M72_CAM_SEQ)
+				llHdl->cam[ch].mode = M72_CAM_OFF;
+			if (llHdl->tbChan == (u_int32)ch)
+				llHdl->tbChan = M72_TIMEBASE_OFF;
 			llHdl->regCountCtrl[ch] &= ~MODE_MASK;
 			llHdl->regCountCtrl[ch] |= (value << 8);
 			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+			IrqActMask(llHdl);
+
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
             break;
+		}
         /*--------------------------+
         |   counter preload cond.   |
         +--------------------------*/
@@ -1380,6 +2456,8 @@ static int32 M72_SetStat(
 				return(ERR_LL_ILL_PARAM);
 
 			CounterStore(llHdl, ch, value);
+			if (value == M72_STORE_NO)
+				llHdl->capture[ch] = FALSE;
             break;
         /*--------------------------+     
         |   irq enable cond.        |
@@ -1387,12 +2465,15 @@ static int32 M72_SetStat(
         case M72_ENB_IRQ:
 			if ( (value == 0) || (value == 1) ) { 
 				llHdl->enbIrq[ch] = value;
+				IrqEnbMask(llHdl);
 				llHdl->regIrqCtrl[ch] &= ~ENB_MASK;
 				llHdl->regIrqCtrl[ch] |= (u_int16)(value << 7);
 				MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(ch), llHdl->regIrqCtrl[ch]);
 
 				if (value == 0) {
 					llHdl->regIntStatChan[ch] = 0;
+					if (llHdl->tbChan == (u_int32)ch)
+						llHdl->tbChan = M72_TIMEBASE_OFF;
 				}
             }
 			else {
@@ -1447,6 +2528,8 @@ static int32 M72_SetStat(
 			llHdl->regIrqCtrl[ch] &= ~XIN2_ENB;
 			llHdl->regIrqCtrl[ch] |= (u_int16)(value << 1);
 			MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(ch), llHdl->regIrqCtrl[ch]);
+			if (!value)
+				llHdl->capture[ch] = FALSE;
             break;
 		/*--------------------------+
         |   interrupt status        |
@@ -1493,10 +2576,14 @@ static int32 M72_SetStat(
         |   read mode               |
         +--------------------------*/
         case M72_READ_MODE:
-			if (!IN_RANGE(value,0,2))		
+			if (!IN_RANGE(value,0,3))
+				return(ERR_LL_ILL_PARAM);
+
+			if (value == M72_READ_QUEUE && llHdl->fifo[ch].depth == 0)
 				return(ERR_LL_ILL_PARAM);
 
 			llHdl->readMode[ch] = value;
+			IrqActMask(llHdl);
             break;
         /*--------------------------+
         |   read timeout            |
@@ -1535,45 +2622,189 @@ static int32 M72_SetStat(
 			if (llHdl->cntMode[ch] != M72_MODE_FREQ)
 				return(ERR_LL_ILL_PARAM);
 
-			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
-					   llHdl->regCountCtrl[ch] | TIMEBASE);
+			MeasStart(llHdl, ch);
 			break;
         /*--------------------------+
-        |   output signal mode      |
-        +--------------------------*/
-        case M72_OUT_MODE:
-			llHdl->regOutCtrl1 = (u_int16)(value & 0xffff);
-			llHdl->regOutCtrl2 = (u_int16)(value >> 16);
-			MWRITE_D16(llHdl->ma, OUT_CTRL1_REG, llHdl->regOutCtrl1);
-			MWRITE_D16(llHdl->ma, OUT_CTRL2_REG, llHdl->regOutCtrl2);
-			break;
-		/*--------------------------+
-        |   output signal setting  |
+        |   continuous measurement  |
         +--------------------------*/
-        case M72_OUT_SET:
-			if (!IN_RANGE(value,0,0x0f))
+        case M72_CONTINUOUS:
+			if (!IN_RANGE(value,0,1))
 				return(ERR_LL_ILL_PARAM);
 
-			MWRITE_D16(llHdl->ma, OUT_CONFIG_REG, (u_int16)(value & 0xf));
+			if (value && ((llHdl->cntMode[ch] != M72_MODE_FREQ &&
+						   llHdl->cntMode[ch] != M72_MODE_PERIOD &&
+						   llHdl->cntMode[ch] != M72_MODE_PULSEH &&
+						   llHdl->cntMode[ch] != M72_MODE_PULSEL) ||
+						  llHdl->fifo[ch].depth == 0))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->continuous[ch] = value;
+			IrqActMask(llHdl);
+
+			if (value)
+				MeasStart(llHdl, ch);
 			break;
         /*--------------------------+
-        |   selftest register config|
+        |   64-bit counter extension|
         +--------------------------*/
-        case M72_SELFTEST:
-			llHdl->regSelftest = (u_int16)value;
-			MWRITE_D16(llHdl->ma, SELFTEST_REG, llHdl->regSelftest);
+        case M72_EXT64:
+			if (!IN_RANGE(value,0,1))
+				return(ERR_LL_ILL_PARAM);
+
+			/* Ext64Wrap overwrites the captured latch */
+			if (value && llHdl->capture[ch])
+				return(ERR_LL_ILL_PARAM);
+
+			Ext64Enable(llHdl, ch, value);
 			break;
-			
-		/*--------------------------+
-        |  signal installation      |
+        /*--------------------------+
+        |   xIN2 capture mode       |
         +--------------------------*/
-        case M72_SIGSET_READY:
-        case M72_SIGSET_COMP:
-        case M72_SIGSET_CYBW:
-        case M72_SIGSET_LBREAK:
-		case M72_SIGSET_XIN2:			
+        case M72_CAPTURE:
 		{
-			/* get index */
+			OSS_IRQ_STATE oldState;
+
+			if (!IN_RANGE(value,0,1))
+				return(ERR_LL_ILL_PARAM);
+
+			if (value && (llHdl->fifo[ch].depth == 0 || llHdl->ext64[ch]))
+				return(ERR_LL_ILL_PARAM);
+
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+			if (value) {
+				CounterStore(llHdl, ch, M72_STORE_IN2);
+
+				llHdl->xin2Irq[ch] = 1;
+				llHdl->regIrqCtrl[ch] |= XIN2_ENB;
+				MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(ch), llHdl->regIrqCtrl[ch]);
+			}
+
+			llHdl->capture[ch] = value;
+			IrqActMask(llHdl);
+
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+			break;
+		}
+        /*--------------------------+
+        |   timebase channel        |
+        +--------------------------*/
+        case M72_TIMEBASE:
+			if ((u_int32)value == M72_TIMEBASE_OFF) {
+				llHdl->tbChan = M72_TIMEBASE_OFF;
+				break;
+			}
+
+			/* carry/borrow must be handled by M72_Irq */
+			if (!IN_RANGE(value,0,CH_NUMBER-1) ||
+				llHdl->cntMode[value] != M72_MODE_TIMER ||
+				!llHdl->enbIrq[value] || llHdl->capture[value])
+				return(ERR_LL_ILL_PARAM);
+
+			Ext64Enable(llHdl, value, TRUE);
+			llHdl->tbChan = value;
+			break;
+        /*--------------------------+
+        |   block read mode         |
+        +--------------------------*/
+        case M72_BLKREAD_MODE:
+			if (!IN_RANGE(value,0,2))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->blkReadMode[ch] = value;
+			break;
+        /*--------------------------+
+        |   FIFO events             |
+        +--------------------------*/
+        case M72_FIFO_EVENTS:
+			if (!IN_RANGE(value,0,CHAN_PEND_MASK))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->fifo[ch].events = value;
+			IrqActMask(llHdl);
+			break;
+        /*--------------------------+
+        |   FIFO overrun counter    |
+        +--------------------------*/
+        case M72_FIFO_OVERRUN:
+			llHdl->fifo[ch].overrun = value;
+			break;
+        /*--------------------------+
+        |   late sequence intervals |
+        +--------------------------*/
+        case M72_SEQ_UNDERRUN:
+			llHdl->cam[ch].underrun = value;
+			break;
+        /*--------------------------+
+        |   flush FIFO              |
+        +--------------------------*/
+        case M72_FIFO_CLEAR:
+		{
+			OSS_IRQ_STATE oldState;
+
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->fifo[ch].in    = 0;
+			llHdl->fifo[ch].out   = 0;
+			llHdl->fifo[ch].count = 0;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+			break;
+		}
+        /*--------------------------+
+        |   event queue overrun cnt.|
+        +--------------------------*/
+        case M72_EVQUEUE_OVERRUN:
+			llHdl->evq.overrun = value;
+			break;
+        /*--------------------------+
+        |   flush event queue       |
+        +--------------------------*/
+        case M72_EVQUEUE_CLEAR:
+		{
+			OSS_IRQ_STATE oldState;
+
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			llHdl->evq.in    = 0;
+			llHdl->evq.out   = 0;
+			llHdl->evq.count = 0;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+			break;
+		}
+        /*--------------------------+
+        |   output signal mode      |
+        +--------------------------*/
+        case M72_OUT_MODE:
+			llHdl->regOutCtrl1 = (u_int16)(value & 0xffff);
+			llHdl->regOutCtrl2 = (u_int16)(value >> 16);
+			MWRITE_D16(llHdl->ma, OUT_CTRL1_REG, llHdl->regOutCtrl1);
+			MWRITE_D16(llHdl->ma, OUT_CTRL2_REG, llHdl->regOutCtrl2);
+			break;
+		/*--------------------------+
+        |   output signal setting  |
+        +--------------------------*/
+        case M72_OUT_SET:
+			if (!IN_RANGE(value,0,0x0f))
+				return(ERR_LL_ILL_PARAM);
+
+			MWRITE_D16(llHdl->ma, OUT_CONFIG_REG, (u_int16)(value & 0xf));
+			break;
+        /*--------------------------+
+        |   selftest register config|
+        +--------------------------*/
+        case M72_SELFTEST:
+			llHdl->regSelftest = (u_int16)value;
+			MWRITE_D16(llHdl->ma, SELFTEST_REG, llHdl->regSelftest);
+			break;
+			
+		/*--------------------------+
+        |  signal installation      |
+        +--------------------------*/
+        case M72_SIGSET_READY:
+        case M72_SIGSET_COMP:
+        case M72_SIGSET_CYBW:
+        case M72_SIGSET_LBREAK:
+		case M72_SIGSET_XIN2:			
+		{
+			/* get index */
 			u_int32 sigNr = code - (M72_SIGSET);
 
 			/* already defined ? */
@@ -1591,6 +2822,8 @@ static int32 M72_SetStat(
 									   &llHdl->sigHdl[ch][sigNr])))
 				return(error);
 
+			llHdl->sigPend |= (u_int32)1 << (sigNr + (ch<<3));
+			IrqActMask(llHdl);
             break;
 		}
         /*--------------------------+
@@ -1612,6 +2845,8 @@ static int32 M72_SetStat(
 			}
 
 			/* remove signal */
+			llHdl->sigPend &= ~((u_int32)1 << (sigNr + (ch<<3)));
+			IrqActMask(llHdl);
 			if ((error = OSS_SigRemove(llHdl->osHdl,
 									   &llHdl->sigHdl[ch][sigNr])))
 				return(error);
@@ -1619,6 +2854,131 @@ static int32 M72_SetStat(
             break;
 		}
         /*--------------------------+
+        |   pretriggering Value    |
+        +--------------------------*/
+        case M72_CNT_PRETRIG:
+			if (value < PRETR_OFFSET)
+				llHdl->cntPretrig = PRETR_OFFSET;
+			else
+				llHdl->cntPretrig = value;
+
+			break;
+        /*--------------------------+
+        | En/disable pretriggering |
+        +--------------------------*/
+        case M72_EN_PRETRIG:
+			error = PretrigEnable(llHdl, value);
+			break;
+        /*--------------------------+
+        | pretrigger timer channels|
+        +--------------------------*/
+        case M72_PRETRIG_PERIOD:
+        case M72_PRETRIG_SET:
+        case M72_PRETRIG_CLR:
+			if (llHdl->ptActive || !IN_RANGE(value,0,CH_NUMBER-1))
+				return(ERR_LL_ILL_PARAM);
+
+			if (code == M72_PRETRIG_PERIOD)
+				llHdl->ptPeriod = value;
+			else if (code == M72_PRETRIG_SET)
+				llHdl->ptSet = value;
+			else
+				llHdl->ptClr = value;
+			break;
+        /*--------------------------+
+        | pretrigger edge fractions|
+        +--------------------------*/
+        case M72_PRETRIG_FSET:
+        case M72_PRETRIG_FCLR:
+			if (llHdl->ptActive || !IN_RANGE(value,0,M72_PRETRIG_FRAC_ONE))
+				return(ERR_LL_ILL_PARAM);
+
+			if (code == M72_PRETRIG_FSET)
+				llHdl->ptFracSet = value;
+			else
+				llHdl->ptFracClr = value;
+			break;
+        /*--------------------------+
+        | pretrigger output line   |
+        +--------------------------*/
+        case M72_PRETRIG_OUT:
+			if (llHdl->ptActive || !IN_RANGE(value,1,4))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->ptOut = value;
+			break;
+        /*--------------------------+
+        | period predictor         |
+        +--------------------------*/
+        case M72_PRETRIG_PRED:
+			if (llHdl->ptActive ||
+				!IN_RANGE(value,M72_PRED_LAST,M72_PRED_TREND))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->ptPredMode = value;
+			break;
+        case M72_PRETRIG_PRED_K:
+			if (llHdl->ptActive || !IN_RANGE(value,0,M72_PRED_K_MAX))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->ptPredK = value;
+			break;
+        case M72_PRETRIG_BAND:
+			if (llHdl->ptActive || !IN_RANGE(value,0,M72_PRETRIG_FRAC_ONE))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->ptBand = value;
+			break;
+        case M72_PRETRIG_LATCOMP:
+			if (llHdl->ptActive || !IN_RANGE(value,0,1))
+				return(ERR_LL_ILL_PARAM);
+
+			llHdl->ptLatComp = value;
+			break;
+        /*--------------------------+
+        | period statistics        |
+        +--------------------------*/
+        case M72_PRETRIG_HBASE:
+        case M72_PRETRIG_HSHIFT:
+        case M72_PRETRIG_SCLEAR:
+		{
+			OSS_IRQ_STATE oldState;
+
+			if (code == M72_PRETRIG_HSHIFT && !IN_RANGE(value,0,31))
+				return(ERR_LL_ILL_PARAM);
+
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+			if (code == M72_PRETRIG_HBASE)
+				llHdl->ptStat.histBase = value;
+			else if (code == M72_PRETRIG_HSHIFT)
+				llHdl->ptStat.histShift = value;
+
+			PretrigStatClear(llHdl);
+
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+			break;
+		}
+        /*--------------------------+
+        |  list of setstats         |
+        +--------------------------*/
+        case M72_BLK_SETSTAT_LIST:
+			error = SetStatList(llHdl, (M72_SETSTAT_ENTRY*)blk->data,
+								blk->size / sizeof(M72_SETSTAT_ENTRY));
+			break;
+        /*--------------------------+
+        |  comparator cam table     |
+        +--------------------------*/
+        case M72_BLK_CAM:
+			error = CamLoad(llHdl, ch, (M72_CAM*)blk->data, blk->size);
+			break;
+        /*--------------------------+
+        |  timer interval sequence  |
+        +--------------------------*/
+        case M72_BLK_SEQ:
+			error = SeqLoad(llHdl, ch, (M72_SEQ*)blk->data, blk->size);
+			break;
+        /*--------------------------+
         |  (unknown)                |
         +--------------------------*/
         default:
@@ -1657,20 +3017,63 @@ static int32 M72_SetStat(
  *                M72_LBREAK_IRQ  	   Line-Break   irq enable    0..1
  *                M72_XIN2_IRQ   	   xIN2 Edge    irq enable    0..1
  *                M72_INT_STATUS       irq status bits            0..0x1f
+ *                M72_IRQ_REJECT       rejected interrupts        0..max
+ *                M72_IRQ_DEFER        deferred irq work [ms]     0..1000
+ *                M72_DEFER_OVERRUN    dropped deferred irqs      0..max
  *                M72_VAL_COMPA        comparator A value         0..max
  *                M72_VAL_COMPB        comparator B value         0..max
- *                M72_READ_MODE        mode for read calls        0..2
+ *                M72_READ_MODE        mode for read calls        0..3
  *                M72_READ_TIMEOUT     timeout for read calls     0..0xffffffff
  *                M72_WRITE_MODE       mode for write calls       0, 2    (1)
  *                M72_TIMER_START      timer start condition      0..1
+ *                M72_BLKREAD_MODE     mode for block read calls  0..2
+ *                M72_FIFO_EVENTS      irq events stored in FIFO  0..0x1f
+ *                M72_FIFO_COUNT       number of FIFO entries     0..max
+ *                M72_FIFO_OVERRUN     lost FIFO entries          0..max
+ *                M72_FIFO_DEPTH       FIFO depth (entries)       0..0x10000
+ *                M72_EVQUEUE_COUNT    number of queued events    0..max
+ *                M72_EVQUEUE_OVERRUN  lost event queue entries   0..max
+ *                M72_READ_SEQ         seq. number of last read   0..max
+ *                M72_CONTINUOUS       continuous measurement     0..1
+ *                M72_EXT64            64-bit counter extension   0..1
+ *                M72_CAPTURE          xIN2 capture mode          0..1
+ *                M72_CAM_MATCHES      cam comparator matches     0..max
+ *                M72_SEQ_UNDERRUN     late sequence intervals    0..max
+ *                M72_EVRING_ADDR      event ring address         -
+ *                M72_BLK_EVRING       copy of event ring         -
+ *                M72_BLK_CONFIG       configuration snapshot     -
+ *                M72_BLK_CNT64        64-bit counter             -
  *                M72_SIGSET_READY     Ready        signal        0..max
  *                M72_SIGSET_COMP      Comparator   signal        0..max
  *                M72_SIGSET_CYBW      Carry/Borrow signal        0..max
  *                M72_SIGSET_LBREAK    Line-Break   signal        0..max
  *                M72_SIGSET_XIN2      xIN2 Edge    signal        0..max 
+ *                M72_TIME_RATE        timestamps per second      1..max
+ *                M72_TIMEBASE         timebase channel           0..3, (4)
+ *                M72_TIME_READY       time of last Ready irq     0..max
+ *                M72_TIME_COMP        time of last Comp. irq     0..max
+ *                M72_TIME_CYBW        time of last Carry/Borrow  0..max
+ *                M72_TIME_LBREAK      time of last Line-Break    0..max
+ *                M72_TIME_XIN2        time of last xIN2 Edge     0..max
  *                M72_OUT_MODE         output signal mode           (2)
  *                M72_OUT_SET          output signal setting      0..0xf
  *                M72_SELFTEST         self-test register      no statements (3)
+ *                M72_CNT_PRETRIG      pretrigger offset [ticks]  25..max
+ *                M72_EN_PRETRIG       pretrigger enabled         0..1
+ *                M72_PRETRIG_PERIOD   period timer channel       0..3
+ *                M72_PRETRIG_SET      set edge timer channel     0..3
+ *                M72_PRETRIG_CLR      clear edge timer channel   0..3
+ *                M72_PRETRIG_FSET     set edge period fraction   0..0x10000
+ *                M72_PRETRIG_FCLR     clear edge period fraction 0..0x10000
+ *                M72_PRETRIG_OUT      pretrigger output line     1..4
+ *                M72_PRETRIG_HBASE    histogram bin 0 bound      0..max
+ *                M72_PRETRIG_HSHIFT   histogram bin width        0..31
+ *                M72_PRETRIG_PRED     period predictor           0..3
+ *                M72_PRETRIG_PRED_K   predictor window/gain      0..4
+ *                M72_PRETRIG_BAND     outlier band               0..0x10000
+ *                M72_PRETRIG_LATCOMP  latency compensation       0..1
+ *                M72_BLK_PRETRIG_STAT pretrigger statistics      -
+ *                M72_BLK_IRQ_PROFILE  ISR profile                -
  *                -------------------  -------------------------  ----------
  *                Note: For values see also m72_drv.h.
  *
@@ -1679,6 +3082,7 @@ static int32 M72_SetStat(
  *                (3) The M72 module supports factory self tests. These test are
  *                    controlled through the Self-test Register. 
  *                    !! THE USER SHOULD NEVER PROGRAM THE SELF-TEST REGISTER !!
+ *                (4) or M72_TIMEBASE_OFF
  *
  *
  *                M72_CNT_MODE returns the counter mode of the current channel.
@@ -1712,6 +3116,18 @@ static int32 M72_SetStat(
  *                    NOTE: When the interrupt status register is polled, events 
  *                          might not be detected.
  *
+ *                M72_IRQ_REJECT returns the number of rejected interrupts,
+ *                i.e. interrupts not caused by an enabled channel (e.g. from
+ *                another device on a shared interrupt line). Handled
+ *                interrupts are counted by M_LL_IRQ_COUNT.
+ *
+ *                M72_IRQ_DEFER returns the period [ms] of the deferred
+ *                interrupt work (0=not deferred).
+ *
+ *                M72_DEFER_OVERRUN returns the number of interrupts (partly)
+ *                dropped by the full deferred work queue (see M72_SetStat:
+ *                M72_IRQ_DEFER).
+ *
  *                M72_VAL_COMPA/B returns the comparator A/B 32-bit value.
  *
  *                M72_READ_MODE returns the read mode of the current channel.
@@ -1722,14 +3138,142 @@ static int32 M72_SetStat(
  *
  *                M72_WRITE_MODE returns the write mode of the current channel.
  *
+ *                M72_BLKREAD_MODE returns the block read mode of the current
+ *                channel.
+ *
+ *                M72_FIFO_EVENTS returns the interrupt events which are
+ *                stored in the FIFO of the current channel.
+ *
+ *                M72_FIFO_COUNT returns the number of entries in the FIFO of
+ *                the current channel.
+ *
+ *                M72_FIFO_OVERRUN returns the number of FIFO entries of the
+ *                current channel which were lost due to a full FIFO.
+ *
+ *                M72_FIFO_DEPTH returns the FIFO depth of the current
+ *                channel (see descriptor key FIFO_DEPTH).
+ *
+ *                M72_EVQUEUE_COUNT returns the number of entries in the
+ *                event queue.
+ *
+ *                M72_EVQUEUE_OVERRUN returns the number of event queue
+ *                entries which were lost due to a full queue.
+ *
+ *                M72_READ_SEQ returns the FIFO sequence number of the value
+ *                returned by the last read call of the current channel in
+ *                read mode M72_READ_QUEUE. (see M72_Read)
+ *
+ *                M72_EVRING_ADDR returns the address of the event ring
+ *                (M72_EVRING structure, see m72_drv.h), or zero if no
+ *                ring was allocated (see descriptor key EVRING_SIZE).
+ *                The ring is filled by the interrupt service routine and
+ *                can be read by any number of applications without system
+ *                calls, each keeping its own tail index (see m72_drv.h).
+ *                    NOTE: Only supported if the driver was built with
+ *                          M72_EVRING_SHARED, which must only be set on
+ *                          operating systems where the driver and the
+ *                          applications share one address space (the
+ *                          address is a kernel address otherwise).
+ *                          Else ERR_LL_UNK_CODE is returned, use
+ *                          M72_BLK_EVRING.
+ *                (treat as non-block!)
+ *
+ *                M72_BLK_EVRING copies the event ring (header and records,
+ *                M72_EVRING_SIZE(size) bytes) to the block buffer. The
+ *                records are read with the same protocol as the ring.
+ *                Records overwritten during the copy are marked invalid
+ *                (wrong 'seq'), readers count them as lost.
+ *                ERR_LL_USERBUF is returned if the buffer is too small,
+ *                ERR_LL_ILL_PARAM if no ring was allocated.
+ *
+ *                M72_BLK_CONFIG copies the configuration of all channels,
+ *                the shadow registers and the interrupt counter to the
+ *                block buffer (M72_CONFIG, see m72_drv.h). The values are
+ *                taken with interrupts masked. The current channel is
+ *                ignored. 'version' and 'size' identify the struct layout;
+ *                ERR_LL_USERBUF is returned if the buffer is too small.
+ *
+ *                M72_BLK_CNT64 latches the counter of the current channel
+ *                and returns it with the upper 32 bits (M72_CNT64, see
+ *                m72_drv.h). A carry/borrow which is not yet handled by the
+ *                interrupt service routine is taken into account.
+ *                ERR_LL_ILL_PARAM is returned if the 64-bit extension is
+ *                disabled (see M72_SetStat: M72_EXT64), ERR_LL_USERBUF if
+ *                the buffer is too small.
+ *
  *                M72_SIGSET_xxx returns the signal code of an installed
  *                signal for the current channel. Zero is returned if no 
  *                signal is installed.
  *
+ *                M72_TIME_RATE returns the number of timestamps per second.
+ *                All timestamps (FIFO, event ring, event queue and
+ *                M72_TIME_xxx) are taken at entry of the interrupt service
+ *                routine, if there is OS-level work (see M72_Irq). Without
+ *                timebase channel they are taken from the Linux monotonic
+ *                clock (1000000, i.e. 1us, Linux kernel build) or the OS
+ *                tick counter (other OSes); 32-bit, the high part is
+ *                always 0. A platform may provide another clock (see switch
+ *                M72_TIMESTAMP). With a timebase channel (see M72_SetStat:
+ *                M72_TIMEBASE), 2500000 is returned.
+ *
+ *                M72_TIMEBASE returns the timebase channel or
+ *                M72_TIMEBASE_OFF.
+ *
+ *                M72_TIME_xxx returns the timestamp (bits 0..31) of the last
+ *                interrupt
+ *                of the respective event of the current channel, e.g. the
+ *                time of the Ready interrupt which released a read call in
+ *                read mode M72_READ_WAIT, or the time of the event which
+ *                caused a signal. It is only updated for events which are
+ *                stored, release a read or send a signal.
+ *
  *                M72_OUT_MODE returns the output signal mode.
  *
  *                M72_OUT_SET returns the current state of the output signals.
  *
+ *                M72_BLK_PRETRIG_STAT returns the statistics of the periods
+ *                measured by the pretrigger interrupt service routine
+ *                (M72_PRETRIG_STAT, see m72_drv.h): number of periods,
+ *                min/max/mean period, variance, histogram (see M72_SetStat:
+ *                M72_PRETRIG_HBASE/HSHIFT) and the number of late preloads,
+ *                i.e. periods where a computed edge timer preload was
+ *                negative or below M72_CNT_PRETRIG, the number of rejected
+ *                outliers, the mean/max. absolute prediction error
+ *                (see M72_SetStat: M72_PRETRIG_PRED), the last/max/mean
+ *                preload latency (ticks between xIN2 edge and preload
+ *                write, i.e. ticks saved per compensated edge) and the
+ *                number of compensated/missed edges (see M72_SetStat:
+ *                M72_PRETRIG_LATCOMP). The variance is
+ *                computed from the deviations to the first period after
+ *                clearing, which are limited to +/-0xffff ticks.
+ *                ERR_LL_USERBUF is returned if the buffer is too small.
+ *
+ *                M72_BLK_IRQ_PROFILE returns the ISR profile
+ *                (M72_ISR_PROFILE, see m72_drv.h), only supported if the
+ *                driver was built with M72_IRQ_PROFILE:
+ *                - the duration of the handled interrupts (entry to exit
+ *                  of M72_Irq, last/max and histogram)
+ *                - the event-to-ISR latency (last/max and histogram),
+ *                  estimated in pretrigger mode from the period timer
+ *                  (timer ticks since the xIN2 edge, see M72_SetStat:
+ *                  M72_EN_PRETRIG). With a timebase channel, the time
+ *                  spent in M72_Irq until the measurement is subtracted,
+ *                  else the value is an upper bound.
+ *                The durations are measured with the timebase channel
+ *                (see M72_SetStat: M72_TIMEBASE), which is required: the
+ *                system tick is too coarse for the duration of M72_Irq,
+ *                so without a timebase channel no durations are recorded
+ *                (count stays 0). Samples are dropped when the timebase
+ *                channel changes during an interrupt; clear the profile
+ *                after changing it (M72_SetStat: M72_PROFILE_CLEAR).
+ *                Histogram bin 0 counts the value 0, bin n (n>0) values
+ *                from 2^(n-1) to 2^n - 1.
+ *                The measurement costs 2 register writes and 2 reads at
+ *                entry and exit of handled interrupts (rejected interrupts
+ *                are not measured) and is compiled out completely without
+ *                M72_IRQ_PROFILE.
+ *                ERR_LL_USERBUF is returned if the buffer is too small.
+ *
  *                (See corresponding codes at M72_SetStat for details)
  *
  *---------------------------------------------------------------------------
@@ -1799,6 +3343,21 @@ static int32 M72_GetStat(
             *valueP = llHdl->irqCount;
             break;
         /*--------------------------+
+        |  irq reject counter       |
+        +--------------------------*/
+        case M72_IRQ_REJECT:
+            *valueP = llHdl->irqReject;
+            break;
+        /*--------------------------+
+        |  deferred irq work        |
+        +--------------------------*/
+        case M72_IRQ_DEFER:
+            *valueP = llHdl->defer.period;
+            break;
+        case M72_DEFER_OVERRUN:
+            *valueP = llHdl->defer.overrun;
+            break;
+        /*--------------------------+
         |  ID PROM check enabled    |
         +--------------------------*/
         case M_LL_ID_CHECK:
@@ -1951,6 +3510,158 @@ static int32 M72_GetStat(
 			*valueP = llHdl->timerStart[ch];
             break;
         /*--------------------------+
+        |   block read mode         |
+        +--------------------------*/
+        case M72_BLKREAD_MODE:
+			*valueP = llHdl->blkReadMode[ch];
+			break;
+        /*--------------------------+
+        |   FIFO events             |
+        +--------------------------*/
+        case M72_FIFO_EVENTS:
+			*valueP = llHdl->fifo[ch].events;
+			break;
+        /*--------------------------+
+        |   FIFO entries            |
+        +--------------------------*/
+        case M72_FIFO_COUNT:
+			*valueP = llHdl->fifo[ch].count;
+			break;
+        /*--------------------------+
+        |   FIFO overrun counter    |
+        +--------------------------*/
+        case M72_FIFO_OVERRUN:
+			*valueP = llHdl->fifo[ch].overrun;
+			break;
+        /*--------------------------+
+        |   FIFO depth              |
+        +--------------------------*/
+        case M72_FIFO_DEPTH:
+			*valueP = llHdl->fifo[ch].depth;
+			break;
+        /*--------------------------+
+        |   event queue entries     |
+        +--------------------------*/
+        case M72_EVQUEUE_COUNT:
+			*valueP = llHdl->evq.count;
+			break;
+        /*--------------------------+
+        |   event queue overrun cnt.|
+        +--------------------------*/
+        case M72_EVQUEUE_OVERRUN:
+			*valueP = llHdl->evq.overrun;
+			break;
+        /*--------------------------+
+        |   seq. number of last read|
+        +--------------------------*/
+        case M72_READ_SEQ:
+			*valueP = llHdl->fifo[ch].readSeq;
+			break;
+        /*--------------------------+
+        |   continuous measurement  |
+        +--------------------------*/
+        case M72_CONTINUOUS:
+			*valueP = llHdl->continuous[ch];
+			break;
+        /*--------------------------+
+        |   64-bit counter extension|
+        +--------------------------*/
+        case M72_EXT64:
+			*valueP = llHdl->ext64[ch];
+			break;
+        /*--------------------------+
+        |   xIN2 capture mode       |
+        +--------------------------*/
+        case M72_CAPTURE:
+			*valueP = llHdl->capture[ch];
+			break;
+        /*--------------------------+
+        |   cam comparator matches  |
+        +--------------------------*/
+        case M72_CAM_MATCHES:
+			*valueP = llHdl->cam[ch].matches;
+			break;
+        /*--------------------------+
+        |   late sequence intervals |
+        +--------------------------*/
+        case M72_SEQ_UNDERRUN:
+			*valueP = llHdl->cam[ch].underrun;
+			break;
+#ifdef M72_EVRING_SHARED
+        /*--------------------------+
+        |   event ring address      |
+        |   (treat as non-block!)   |
+        +--------------------------*/
+        case M72_EVRING_ADDR:
+			*value64P = (INT32_OR_64)llHdl->evRing;
+			break;
+#endif
+        /*--------------------------+
+        |   copy of event ring      |
+        +--------------------------*/
+        case M72_BLK_EVRING:
+		{
+			M72_EVRING *ring = llHdl->evRing;
+			M72_EVRING *copy = (M72_EVRING*)blk->data;
+			u_int32 ringSize, head, idx;
+
+			if (ring == NULL)
+				return(ERR_LL_ILL_PARAM);
+
+			ringSize = M72_EVRING_SIZE(ring->size);
+
+			if ((u_int32)blk->size < ringSize)
+				return(ERR_LL_USERBUF);
+
+			/* header first: records are not older than 'head' */
+			OSS_MemCopy(llHdl->osHdl, sizeof(M72_EVRING) - sizeof(M72_EVRING_REC),
+						(char*)ring, (char*)copy);
+			M72_EVRING_BARRIER();
+			OSS_MemCopy(llHdl->osHdl, ringSize - (sizeof(M72_EVRING) - sizeof(M72_EVRING_REC)),
+						(char*)ring->rec, (char*)copy->rec);
+			M72_EVRING_BARRIER();
+
+			/*
+			 * Records copied while M72_Irq overwrote them may be torn
+			 * with an intact 'seq' (copied before the new record was
+			 * started). M72_Irq wrote records copy->head..head (the
+			 * last one maybe still in progress): invalidate each copied
+			 * record whose 'seq' changed since.
+			 */
+			head = ring->head;
+			for (idx = copy->head;
+				 idx - copy->head <= head - copy->head &&
+				 idx - copy->head < ring->size; idx++) {
+
+				M72_EVRING_REC *rec = &copy->rec[idx & llHdl->evRingMask];
+
+				if (rec->seq != ring->rec[idx & llHdl->evRingMask].seq)
+					rec->seq = ~(idx - ring->size);
+			}
+			break;
+		}
+        /*--------------------------+
+        |   configuration snapshot  |
+        +--------------------------*/
+        case M72_BLK_CONFIG:
+			if ((u_int32)blk->size < sizeof(M72_CONFIG))
+				return(ERR_LL_USERBUF);
+
+			ConfigGet(llHdl, (M72_CONFIG*)blk->data);
+			break;
+        /*--------------------------+
+        |   64-bit counter          |
+        +--------------------------*/
+        case M72_BLK_CNT64:
+			if (!llHdl->ext64[ch])
+				return(ERR_LL_ILL_PARAM);
+
+			if ((u_int32)blk->size < sizeof(M72_CNT64))
+				return(ERR_LL_USERBUF);
+
+			Ext64Read(llHdl, ch, (M72_CNT64*)blk->data);
+			break;
+        /*--------------------------+
         |   output signal mode      |
         +--------------------------*/
         case M72_OUT_MODE:
@@ -1989,32 +3700,178 @@ static int32 M72_GetStat(
             break;
 		}
         /*--------------------------+
-        |  (unknown)                |
+        |  timestamps per second    |
         +--------------------------*/
-        default:
-            error = ERR_LL_UNK_CODE;
-    }
-
-	return(error);
-}
-
-/******************************* M72_BlockRead *******************************
- *
- *  Description:  Read a data block from the device
- *
- *                The function is not supported and always returns an
- *                ERR_LL_READ error.
- *
- *---------------------------------------------------------------------------
- *  Input......:  llHdl        low-level handle
- *                ch           current channel
- *                buf          data buffer
- *                size         data buffer size
- *  Output.....:  nbrRdBytesP  number of read bytes
- *                return       success (0) or error code
- *  Globals....:  ---
- ****************************************************************************/
-static int32 M72_BlockRead(
+        case M72_TIME_RATE:
+			if (llHdl->tbChan != M72_TIMEBASE_OFF)
+				*valueP = TIMEBASE_RATE;
+			else
+				*valueP = M72_TIMESTAMP_RATE(llHdl);
+			break;
+        /*--------------------------+
+        |  timebase channel         |
+        +--------------------------*/
+        case M72_TIMEBASE:
+			*valueP = llHdl->tbChan;
+			break;
+        /*--------------------------+
+        |  time of last irq event   |
+        +--------------------------*/
+        case M72_TIME_READY:
+        case M72_TIME_COMP:
+        case M72_TIME_CYBW:
+        case M72_TIME_LBREAK:
+        case M72_TIME_XIN2:
+			*valueP = llHdl->evTime[ch][code - (M72_TIME)];
+			break;
+         /*--------------------------+
+        |   TimerB pretrigger Value |
+        +--------------------------*/
+        case M72_CNT_PRETRIG:
+			*valueP = llHdl->cntPretrig;
+            break;
+        /*--------------------------+
+        | pretrigger en/disabled?  |
+        +--------------------------*/
+        case M72_EN_PRETRIG:
+			*valueP = llHdl->enPretrig;
+			break;
+        /*--------------------------+
+        | pretrigger engine config |
+        +--------------------------*/
+        case M72_PRETRIG_PERIOD:
+			*valueP = llHdl->ptPeriod;
+			break;
+        case M72_PRETRIG_SET:
+			*valueP = llHdl->ptSet;
+			break;
+        case M72_PRETRIG_CLR:
+			*valueP = llHdl->ptClr;
+			break;
+        case M72_PRETRIG_FSET:
+			*valueP = llHdl->ptFracSet;
+			break;
+        case M72_PRETRIG_FCLR:
+			*valueP = llHdl->ptFracClr;
+			break;
+        case M72_PRETRIG_OUT:
+			*valueP = llHdl->ptOut;
+			break;
+        case M72_PRETRIG_HBASE:
+			*valueP = llHdl->ptStat.histBase;
+			break;
+        case M72_PRETRIG_HSHIFT:
+			*valueP = llHdl->ptStat.histShift;
+			break;
+        case M72_PRETRIG_PRED:
+			*valueP = llHdl->ptPredMode;
+			break;
+        case M72_PRETRIG_PRED_K:
+			*valueP = llHdl->ptPredK;
+			break;
+        case M72_PRETRIG_BAND:
+			*valueP = llHdl->ptBand;
+			break;
+        case M72_PRETRIG_LATCOMP:
+			*valueP = llHdl->ptLatComp;
+			break;
+        /*--------------------------+
+        | period statistics        |
+        +--------------------------*/
+        case M72_BLK_PRETRIG_STAT:
+			if ((u_int32)blk->size < sizeof(M72_PRETRIG_STAT))
+				return(ERR_LL_USERBUF);
+
+			PretrigStatGet(llHdl, (M72_PRETRIG_STAT*)blk->data);
+			break;
+#ifdef M72_IRQ_PROFILE
+        /*--------------------------+
+        | ISR profile               |
+        +--------------------------*/
+        case M72_BLK_IRQ_PROFILE:
+			if ((u_int32)blk->size < sizeof(M72_ISR_PROFILE))
+				return(ERR_LL_USERBUF);
+
+			ProfGet(llHdl, (M72_ISR_PROFILE*)blk->data);
+			break;
+#endif
+        /*--------------------------+
+        |  (unknown)                |
+        +--------------------------*/
+        default:
+            error = ERR_LL_UNK_CODE;
+    }
+
+	return(error);
+}
+
+/******************************* M72_BlockRead *******************************
+ *
+ *  Description:  Read a data block from the device
+ *
+ *                Depending on the block read mode of the current channel
+ *                (see M72_SetStat: M72_BLKREAD_MODE), the function
+ *                returns either a snapshot of all channels or the entries
+ *                of the channel's FIFO.
+ *
+ *                - M72_BLKREAD_SNAPSHOT
+ *
+ *                The function returns a coherent snapshot of all channels
+ *                (M72_SNAPSHOT structure, see m72_drv.h).
+ *
+ *                With interrupts masked, the counters of all channels with
+ *                read mode M72_READ_NOW are latched back to back. Then the
+ *                counter latches of all channels and the interrupt status
+ *                bits are read. Channels with other read modes are not
+ *                latched, i.e. their latch (e.g. a measurement result) is
+ *                returned unchanged.
+ *
+ *                In pretrigger mode (M72_EN_PRETRIG) the pretrigger timers
+ *                are not latched, since the interrupt service routine
+ *                evaluates the xIN2 latch of the period timer.
+ *
+ *                The interrupt status bits of a channel are taken from the
+ *                Interrupt Status Shadow Register if IRQEN is set, otherwise
+ *                from the Interrupt Status Register on hardware
+ *                (see M72_GetStat: M72_INT_STATUS).
+ *
+ *                ERR_LL_USERBUF is returned if the buffer is too small.
+ *
+ *                - M72_BLKREAD_FIFO
+ *
+ *                The function moves as many entries (M72_FIFO_ENTRY
+ *                structure, see m72_drv.h) as fit into the buffer from the
+ *                FIFO of the current channel. The FIFO is filled by the
+ *                interrupt service routine (see M72_SetStat:
+ *                M72_FIFO_EVENTS). The function does not wait for entries,
+ *                i.e. zero bytes are returned if the FIFO is empty.
+ *
+ *                ERR_LL_ILL_PARAM is returned if no FIFO was allocated for
+ *                the channel (see descriptor key FIFO_DEPTH).
+ *
+ *                - M72_BLKREAD_EVQUEUE
+ *
+ *                The function moves as many entries (M72_EVENT structure,
+ *                see m72_drv.h) as fit into the buffer from the event queue,
+ *                which collects the events of all channels. If the queue is
+ *                empty, the function waits for an event. The read timeout
+ *                of the current channel is used (see M72_SetStat:
+ *                M72_READ_TIMEOUT).
+ *
+ *                ERR_LL_ILL_PARAM is returned if no event queue was
+ *                allocated (see descriptor key EVQUEUE_DEPTH),
+ *                ERR_LL_USERBUF if the buffer can't hold one entry.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......:  llHdl        low-level handle
+ *                ch           current channel
+ *                buf          data buffer
+ *                size         data buffer size
+ *  Output.....:  nbrRdBytesP  number of read bytes
+ *                return       success (0) or error code
+ *  Globals....:  ---
+ ****************************************************************************/
+static int32 M72_BlockRead(
      LL_HANDLE *llHdl,
      int32     ch,
      void      *buf,
@@ -2022,20 +3879,109 @@ static int32 M72_BlockRead(
      int32     *nbrRdBytesP
 )
 {
+	M72_SNAPSHOT *snap = (M72_SNAPSHOT*)buf;
+	u_int32 n, irq_state;
+	u_int32 latch[CH_NUMBER];
+	OSS_IRQ_STATE oldState;
+
     DBGWRT_1((DBH, "LL - M72_BlockRead: ch=%d, size=%d\n",ch,size));
 
 	/* return number of read bytes */
 	*nbrRdBytesP = 0;
 
-	return(ERR_LL_READ);
+	/*----------------------------+
+	|  drain FIFO                 |
+	+----------------------------*/
+	if (llHdl->blkReadMode[ch] == M72_BLKREAD_FIFO)
+		return( FifoRead(llHdl, ch, (M72_FIFO_ENTRY*)buf, size, nbrRdBytesP) );
+
+	/*----------------------------+
+	|  wait for/drain event queue |
+	+----------------------------*/
+	if (llHdl->blkReadMode[ch] == M72_BLKREAD_EVQUEUE)
+		return( EvQueueRead(llHdl, ch, (M72_EVENT*)buf, size, nbrRdBytesP) );
+
+	/*----------------------------+
+	|  snapshot of all channels   |
+	+----------------------------*/
+	if (size < (int32)sizeof(M72_SNAPSHOT))
+		return(ERR_LL_USERBUF);
+
+	/* pretrigger timers are configured directly (see PretrigSetup) */
+	for (n=0; n<CH_NUMBER; n++)
+		latch[n] = (llHdl->readMode[n] == M72_READ_NOW) &&
+				   !(llHdl->ptActive && (n == llHdl->ptPeriod ||
+										 n == llHdl->ptSet ||
+										 n == llHdl->ptClr));
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	/*----------------------------+
+	|  force counter latches      |
+	+----------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (latch[n])
+			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(n),
+					   (u_int16)((llHdl->regCountCtrl[n] & ~STORE_MASK) |
+								 (M72_STORE_NOW << 4)));
+	}
+
+	/* restore config */
+	for (n=0; n<CH_NUMBER; n++) {
+		if (latch[n])
+			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(n), llHdl->regCountCtrl[n]);
+	}
+
+	/*----------------------------+
+	|  read counter latches       |
+	+----------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		snap->count[n]  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(n));
+		snap->count[n] |= (u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(n)) << 16;
+	}
+
+	/*----------------------------+
+	|  read irq status            |
+	+----------------------------*/
+	irq_state = ( (MREAD_D16(llHdl->ma, IRQ_STATE_REG1)) |
+				  (u_int32)(MREAD_D16(llHdl->ma, IRQ_STATE_REG2) << 16) );
+
+	snap->intStatus = 0;
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n])		/* shadow register */
+			snap->intStatus |= (u_int32)llHdl->regIntStatChan[n] << (n<<3);
+		else						/* int. stat. reg. */
+			snap->intStatus |= irq_state & (0x1f << (n<<3));
+	}
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	DBGWRT_2((DBH, " snapshot: %08x %08x %08x %08x stat=%08x\n",
+			  snap->count[0], snap->count[1], snap->count[2], snap->count[3],
+			  snap->intStatus));
+
+	/* return number of read bytes */
+	*nbrRdBytesP = sizeof(M72_SNAPSHOT);
+
+	return(ERR_SUCCESS);
 }
 
 /****************************** M72_BlockWrite *******************************
  *
  *  Description:  Write a data block to the device
  *
- *                The function is not supported and always returns an
- *                ERR_LL_WRITE error.
+ *                The function loads the counter preload registers of
+ *                several channels (M72_PRELOAD_BATCH structure, see
+ *                m72_drv.h). The current channel is ignored.
+ *
+ *                With interrupts masked, the preload registers of all
+ *                channels selected in 'chanMask' are written first. Then,
+ *                if 'loadNow' is set, the counter load is forced on all
+ *                selected channels back to back, regardless of the
+ *                channels' write mode.
+ *
+ *                ERR_LL_USERBUF is returned if the buffer is too small,
+ *                ERR_LL_ILL_PARAM if 'chanMask' or 'loadNow' is invalid.
  *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl        low-level handle
@@ -2054,12 +4000,63 @@ static int32 M72_BlockWrite(
      int32     *nbrWrBytesP
 )
 {
+	M72_PRELOAD_BATCH *batch = (M72_PRELOAD_BATCH*)buf;
+	OSS_IRQ_STATE oldState;
+	u_int32 n;
+
     DBGWRT_1((DBH, "LL - M72_BlockWrite: ch=%d, size=%d\n",ch,size));
 
 	/* return number of written bytes */
 	*nbrWrBytesP = 0;
 
-	return(ERR_LL_WRITE);
+	if (size < (int32)sizeof(M72_PRELOAD_BATCH))
+		return(ERR_LL_USERBUF);
+
+	if ((batch->chanMask & ~((1 << CH_NUMBER) - 1)) || batch->loadNow > 1)
+		return(ERR_LL_ILL_PARAM);
+
+	DBGWRT_2((DBH, " chanMask=0x%x loadNow=%d\n",
+			  batch->chanMask, batch->loadNow));
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	/*----------------------------+
+	|  write counter preloads     |
+	+----------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (batch->chanMask & (1 << n)) {
+			llHdl->valPreload[n] = batch->preload[n];
+			MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(n),
+					   (u_int16)(batch->preload[n] & 0xffff));
+			MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(n),
+					   (u_int16)(batch->preload[n] >> 16));
+		}
+	}
+
+	/*----------------------------+
+	|  force counter loads        |
+	+----------------------------*/
+	if (batch->loadNow) {
+		for (n=0; n<CH_NUMBER; n++) {
+			if (batch->chanMask & (1 << n))
+				MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(n),
+						   (u_int16)((llHdl->regCountCtrl[n] & ~PRELOAD_MASK) |
+									 (M72_PRELOAD_NOW << 2)));
+		}
+
+		/* restore config */
+		for (n=0; n<CH_NUMBER; n++) {
+			if (batch->chanMask & (1 << n))
+				MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(n), llHdl->regCountCtrl[n]);
+		}
+	}
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	/* return number of written bytes */
+	*nbrWrBytesP = sizeof(M72_PRELOAD_BATCH);
+
+	return(ERR_SUCCESS);
 }
 
 
@@ -2088,13 +4085,54 @@ static int32 M72_BlockWrite(
  *                  The shadow registers are updated (ORed with current 
  *                  Interrupt Status Register information).
  *                  The pending flags of the Interrupt Status Registers are
- *                  cleared. The function sends the correponding user signals
+ *                  cleared. The function stores the counter latch in the
+ *                  channel's FIFO, the event ring and the event queue for the
+ *                  configured events
+ *                  (see M72_SetStat: M72_FIFO_EVENTS), sends the correponding user signals
  *                  if installed and releases a read semaphore when needed.
+ *                  With continuous measurement, the measurement is restarted
+ *                  at the Ready interrupt (see M72_SetStat: M72_CONTINUOUS).
+ *                  In capture mode, the latch is stored at each xIN2 Edge
+ *                  interrupt (see M72_SetStat: M72_CAPTURE).
+ *                  With a cam table or an interval sequence, the next
+ *                  compare position/interval is written at the Comparator
+ *                  interrupt (see M72_SetStat: M72_BLK_CAM, M72_BLK_SEQ).
+ *                  The time of the interrupt is stored for each event with
+ *                  OS-level work (see M72_GetStat: M72_TIME_xxx) and in each
+ *                  FIFO, event ring and event queue entry.
+ *                  With 64-bit extension, the upper 32 bits of the counter
+ *                  are updated at the Carry/Borrow interrupt (see
+ *                  M72_SetStat: M72_EXT64). With a timebase channel, the
+ *                  timestamp is latched from this channel (see M72_SetStat:
+ *                  M72_TIMEBASE).
+ *                  In pretrigger mode, the edge timers are preloaded at the
+ *                  xIN2 Edge interrupt of the period timer (see
+ *                  M72_SetStat: M72_EN_PRETRIG). This is a single flag test
+ *                  in normal mode.
+ *                  Only the pending bits of causes with a consumer are
+ *                  dispatched (see IrqActMask), in one pass over the
+ *                  pending bits: the counter is latched if events are
+ *                  stored, the cause is handled (continuous measurement,
+ *                  cam table, 64-bit extension, Line-Break) and the
+ *                  OS-level work (storing events, releasing semaphores,
+ *                  sending signals) is done directly or collected in the
+ *                  queue for IrqWork (deferred, see M72_SetStat:
+ *                  M72_IRQ_DEFER).
+ *                  Without OS-level work, no timestamp is taken and no work
+ *                  is queued. Signals only (no storage, read or cause
+ *                  handled by the driver) are sent in a short loop.
  *
  *                If IRQEN is not set in the Interrupt Control Register:
  *                  The bits in the Interrupt Status Registers are ignored.
  *                  Shadow registers for Interrupt Status Registers are set
- *                  to zero.
+ *                  to zero (when the interrupt is disabled).
+ *
+ *                Only the Interrupt Status Registers of channel pairs with
+ *                an enabled interrupt are read and only registers with
+ *                pending bits are written back. If no enabled channel has
+ *                a pending bit (e.g. interrupt of another device on a shared
+ *                line), the routine returns immediately and counts the
+ *                interrupt as rejected (see M72_GetStat: M72_IRQ_REJECT).
  *
  *---------------------------------------------------------------------------
  *  Input......:  llHdl    low-level handle
@@ -2107,35 +4145,83 @@ static int32 M72_Irq(
    LL_HANDLE *llHdl
 )
 {
-	u_int32 n;
-	u_int32 irq_state, bitmask = 0x1f;
+	u_int32 n, i, bit, pend, act, os, first, chan, tb;
+	u_int32 irq_state = 0, mask = llHdl->irqEnbMask;
+	u_int32 cause, store, value, queued = FALSE;
+	u_int32 ptLatched = FALSE;
+	M72_CNT64 stamp;
+	IRQ_WORK *work = NULL;
+#ifdef M72_IRQ_PROFILE
+	u_int32 profTb, profEntry = 0, lat;
+	u_int32 ptXin2;
+#endif
 
     IDBGWRT_1((DBH, ">>> M72_Irq:\n"));
 
 	/*-------------------------------+ 
-	|  read/reset pending irq flags  | 
-	|  and update shadow registers   |
+	|  read pending irq flags of     | 
+	|  enabled channels only         |
 	+-------------------------------*/
-	irq_state = ( (MREAD_D16(llHdl->ma, IRQ_STATE_REG1)) | 
-		          (u_int32)(MREAD_D16(llHdl->ma, IRQ_STATE_REG2) << 16) );
+	if (mask & 0xffff)
+		irq_state  = MREAD_D16(llHdl->ma, IRQ_STATE_REG1);
+	if (mask >> 16)
+		irq_state |= (u_int32)MREAD_D16(llHdl->ma, IRQ_STATE_REG2) << 16;
 
-	for (n=0; n<CH_NUMBER; n++) {
-		if (llHdl->enbIrq[n]) {
-			llHdl->regIntStatChan[n] |= ( (irq_state >> (n<<3)) & bitmask ); /* update shadow reg. */
-		} 
-		else {
-			llHdl->regIntStatChan[n] = 0;		/* set shadow register to zero */
-			irq_state &= ~(bitmask << (n<<3));  /* irqen = 0 -> irqstate is not relevant now */
-		}
-	}
-	
-    /* reset irq flags */
-	MWRITE_D16(llHdl->ma, IRQ_STATE_REG1, (u_int16)irq_state);
-	MWRITE_D16(llHdl->ma, IRQ_STATE_REG2, (u_int16)(irq_state>>16));
+	/* irqen = 0 -> irqstate is not relevant now */
+	irq_state &= mask;
 
 	/* no interrupt pending ? */
-	if (irq_state == 0)
+	if (irq_state == 0) {
+		llHdl->irqReject++;
 		return(LL_IRQ_DEV_NOT);		/* say: not caused by device */
+	}
+
+#ifdef M72_IRQ_PROFILE
+	/* entry time (timebase channel only) */
+	profTb = llHdl->tbChan;
+	if (profTb != M72_TIMEBASE_OFF)
+		profEntry = ProfTime(llHdl);
+#endif
+
+	/* timestamp of OS-level work only (timebase channel: latched below) */
+	os = irq_state & llHdl->osPend;
+	stamp.low  = (os && llHdl->tbChan == M72_TIMEBASE_OFF) ?
+		M72_TIMESTAMP(llHdl) : 0;
+	stamp.high = 0;
+
+    /* reset irq flags */
+	if (irq_state & 0xffff)
+		MWRITE_D16(llHdl->ma, IRQ_STATE_REG1, (u_int16)irq_state);
+	if (irq_state >> 16)
+		MWRITE_D16(llHdl->ma, IRQ_STATE_REG2, (u_int16)(irq_state>>16));
+
+	/* update shadow registers */
+	for (n=0; n<CH_NUMBER; n++)
+		llHdl->regIntStatChan[n] |= (u_int8)(irq_state >> (n<<3));
+
+	/* pretrigger mode: preload edge timers first */
+#ifdef M72_IRQ_PROFILE
+	ptXin2 = llHdl->ptActive && (irq_state & XIN2_PEND(llHdl->ptPeriod));
+#endif
+	if (llHdl->ptActive)
+		ptLatched = PretrigIrq(llHdl, irq_state);
+
+#ifdef M72_IRQ_PROFILE
+	/* event-to-ISR latency from the period timer */
+	if (ptXin2 && llHdl->ptActive) {
+		lat = llHdl->ptStat.latency;
+		if (profTb != M72_TIMEBASE_OFF && profTb == llHdl->tbChan) {
+			n = ProfTime(llHdl) - profEntry;
+			lat = (n < lat) ? lat - n : 0;
+		}
+
+		llHdl->prof.latCount++;
+		llHdl->prof.latLast = lat;
+		if (lat > llHdl->prof.latMax)
+			llHdl->prof.latMax = lat;
+		llHdl->prof.latHist[ProfBin(lat)]++;
+	}
+#endif
 
 #ifdef DBG
 	/* print pending flags */
@@ -2152,48 +4238,152 @@ static int32 M72_Irq(
 	DBGWRT_2((DBH,"\n"));
 #endif
 
-	/*------------------------------------------------------+ 
-	|  if IRQEN = 1 for channel: send signals if installed  |
-	+------------------------------------------------------*/
-	for (n=0; n<CH_NUMBER; n++) {
-		if (llHdl->enbIrq[n]) {
-			/* Ready  irq ? */
-			if (irq_state & READY_PEND(n)) {  
-				/* send signal if installed */
-				if (llHdl->sigHdl[n][0]) {
-					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][0]);
+	/*-------------------------------+ 
+	|  causes with consumer only     | 
+	|  (see IrqActMask)              |
+	+-------------------------------*/
+	act = irq_state & llHdl->actPend;
+
+	/* timebase channel: update 64-bit extension, latch timestamp */
+	tb = llHdl->tbChan;
+	if (act && tb != M72_TIMEBASE_OFF) {
+		if ((act & CYBW_PEND(tb)) && llHdl->ext64[tb])
+			Ext64Wrap(llHdl, tb);
+		if (os)
+			Ext64Latch(llHdl, tb, &stamp);
+	}
+
+	/* deferred irq work: collected in next queue entry (see DeferNext) */
+	if (os && llHdl->defer.period) {
+		work = DeferNext(llHdl);
+		work->irqState  = 0;
+		work->stampLow  = stamp.low;
+		work->stampHigh = stamp.high;
+		work->fifoStore = 0;
+		work->evStore   = 0;
+		for (n=0; n<CH_NUMBER; n++)
+			work->fifoLost[n] = work->evLost[n] = 0;
+	}
+
+	/* channels storing events or releasing a read */
+	chan = act & (llHdl->fifoPend | llHdl->evPend | llHdl->wakePend);
+
+	/*-------------------------------+ 
+	|  signals only: no storage,     | 
+	|  read or driver handling       |
+	+-------------------------------*/
+	if (!work && !chan && !(act & llHdl->hwPend)) {
+		for (pend = act; pend; pend &= pend - 1) {
+			i = FIRST_BIT(pend);
+			llHdl->evTime[i >> 3][i & 7] = stamp.low;
+			OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[i >> 3][i & 7]);
+		}
+	}
+	/*-------------------------------+ 
+	|  otherwise: one pass over the  | 
+	|  pending bits with consumer    |
+	+-------------------------------*/
+	else {
+		/* lowest pending bit of each channel (no carry between the bytes) */
+		first = act & ((act ^ 0x1f1f1f1f) + 0x01010101);
+
+		for (pend = act; pend; pend &= pend - 1) {
+			i   = FIRST_BIT(pend);
+			n   = i >> 3;
+			bit = (u_int32)1 << i;
+
+			/* first bit of channel: store events, wake up reads */
+			if ((bit & first) && (chan & (CHAN_PEND_MASK << (n<<3)))) {
+				/* entries carry all pending causes of the channel */
+				cause = (irq_state >> (n<<3)) & CHAN_PEND_MASK;
+
+				store = value = 0;
+				if ((llHdl->fifoPend >> (n<<3)) & cause)
+					store |= STORE_FIFO;
+				if ((llHdl->evPend >> (n<<3)) & cause)
+					store |= STORE_EV;
+
+				if (store) {
+					/* period timer: latch overwritten by PretrigLatComp */
+					if (ptLatched && n == llHdl->ptPeriod) {
+						value = llHdl->ptLatch;
+					}
+					else {
+						value  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(n));
+						value |= (u_int32)MREAD_D16(llHdl->ma,
+											COUNT_HIGH_REG(n)) << 16;
+					}
+				}
+
+				if (work) {
+					work->irqState |= cause << (n<<3);
+					work->value[n]  = value;
+					if (store & STORE_FIFO)
+						work->fifoStore |= 1 << n;
+					if (store & STORE_EV)
+						work->evStore   |= 1 << n;
 				}
-				/* handle read mode */
-				if (llHdl->readMode[n] == M72_READ_WAIT) {
-					OSS_SemSignal(llHdl->osHdl, llHdl->readSemHdl[n]);
+				else {
+					queued |= IrqStore(llHdl, n, cause, store, value, &stamp);
+					IrqWake(llHdl, n, cause, store);
 				}
 			}
 
-			/* Comparator irq ? */
-			if ((irq_state & COMP_PEND(n)) && llHdl->sigHdl[n][1])
-				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][1]);
-
-			/* Carry/Borrow irq ? */
-			if ((irq_state & CYBW_PEND(n)) && llHdl->sigHdl[n][2])
-				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][2]);
-
-			/* Line-Break irq ? */
-			if (irq_state & LBREAK_PEND(n)) {
-				/* send signal if installed */
-				if (llHdl->sigHdl[n][3]) {
-					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][3]);
+			/* cause handled by the driver */
+			if (bit & llHdl->hwPend) {
+				switch (i & 7) {
+					case 0:		/* Ready: restart continuous measurement */
+						if (llHdl->continuous[n])
+							MeasStart(llHdl, n);
+						break;
+					case 1:		/* Comparator: next cam position/interval */
+						if (llHdl->cam[n].mode)
+							CamNext(llHdl, n);
+						break;
+					case 2:		/* Carry/Borrow: timebase see above */
+						if (llHdl->ext64[n] && n != tb)
+							Ext64Wrap(llHdl, n);
+						break;
+					case 3:		/* Line-Break: disable Line-Break irq */
+						llHdl->lbreakIrq[n] = 0;
+						llHdl->regIrqCtrl[n] &= ~LBREAK_ENB;
+						MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(n),
+								   llHdl->regIrqCtrl[n]);
+						break;
 				}
-				/* disable Line-Break irq */
-				llHdl->lbreakIrq[n] = 0;
-				llHdl->regIrqCtrl[n] &= ~LBREAK_ENB;
-				MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(n), llHdl->regIrqCtrl[n]);
 			}
-		
-			/* xIN2 Edge irq ? */
-			if ((irq_state & XIN2_PEND(n)) && llHdl->sigHdl[n][4])
-				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][4]);
+
+			/* time of event, signal (deferred: see IrqWork) */
+			if (work) {
+				work->irqState |= bit & os;
+			}
+			else if (bit & os) {
+				llHdl->evTime[n][i & 7] = stamp.low;
+				if (bit & llHdl->sigPend)
+					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][i & 7]);
+			}
 		}
-	}	
+	}
+
+	if (work)
+		DeferPut(llHdl, work);
+
+	/* wake up event queue reader */
+	if (queued)
+		OSS_SemSignal(llHdl->osHdl, llHdl->evq.semHdl);
+
+#ifdef M72_IRQ_PROFILE
+	/* ISR duration */
+	if (profTb != M72_TIMEBASE_OFF && profTb == llHdl->tbChan) {
+		n = ProfTime(llHdl) - profEntry;
+
+		llHdl->prof.count++;
+		llHdl->prof.durLast = n;
+		if (n > llHdl->prof.durMax)
+			llHdl->prof.durMax = n;
+		llHdl->prof.durHist[ProfBin(n)]++;
+	}
+#endif
 
 	llHdl->irqCount++;			
 	return(LL_IRQ_DEVICE);		/* say: caused by device */
@@ -2341,7 +4531,8 @@ static char* Ident( void )  /* nodoc */
 /********************************* Cleanup **********************************
  *
  *  Description: Close all handles, deinstall all installed signals and 
- *               semaphores, free memory and return error code
+ *               semaphores, free memory (FIFOs, event ring, handle) and
+ *               return error code
  *		         NOTE: The low-level handle is invalid after this function is
  *                     called.
  *			   
@@ -2361,6 +4552,14 @@ static int32 Cleanup(
     /*------------------------------+
     |  close handles                |
     +------------------------------*/
+	/* clean up deferred irq work alarm */
+	if (llHdl->defer.alarmHdl) {
+		OSS_AlarmClear(llHdl->osHdl, llHdl->defer.alarmHdl);
+		while (llHdl->defer.busy)
+			OSS_Delay(llHdl->osHdl, 1);
+		OSS_AlarmRemove(llHdl->osHdl, &llHdl->defer.alarmHdl);
+	}
+
 	/* clean up microwire handle */
 	if (llHdl->mcrwHdl) {
 		llHdl->mcrwHdl->Exit((void**)&llHdl->mcrwHdl);
@@ -2371,6 +4570,7 @@ static int32 Cleanup(
 		DESC_Exit(&llHdl->descHdl);
 
 	/* clean up signals */
+	llHdl->sigPend = 0;
 	for (n=0; n<CH_NUMBER; n++) {
 		for (sigNr=0; sigNr<SIG_COUNT; sigNr++) {
 			if (llHdl->sigHdl[n][sigNr])
@@ -2383,6 +4583,31 @@ static int32 Cleanup(
 		OSS_SemRemove(llHdl->osHdl, &llHdl->readSemHdl[n]);
 	}
 
+	if (llHdl->evq.semHdl)
+		OSS_SemRemove(llHdl->osHdl, &llHdl->evq.semHdl);
+
+	/* free FIFOs */
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->fifo[n].buf)
+			OSS_MemFree(llHdl->osHdl, (int8*)llHdl->fifo[n].buf,
+						llHdl->fifo[n].bufSize);
+	}
+
+	/* free event ring */
+	if (llHdl->evRing)
+		OSS_MemFree(llHdl->osHdl, (int8*)llHdl->evRing, llHdl->evRingAlloc);
+
+	/* free event queue */
+	if (llHdl->evq.buf)
+		OSS_MemFree(llHdl->osHdl, (int8*)llHdl->evq.buf, llHdl->evq.bufSize);
+
+	/* free cam tables */
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->cam[n].buf)
+			OSS_MemFree(llHdl->osHdl, (int8*)llHdl->cam[n].buf,
+						llHdl->cam[n].bufSize);
+	}
+
 	/* clean up debug */
 	DBGEXIT((&DBH));
 
@@ -2527,6 +4752,2521 @@ static void CounterLoad(
 	}
 }
 
+/********************************* FifoPut **********************************
+ *
+ *  Description: Store counter latch of given channel in the channel's FIFO
+ *
+ *               Called from M72_Irq. If the FIFO is full, the entry is
+ *               dropped and the overrun counter is incremented. The
+ *               sequence number is incremented in any case, so lost
+ *               entries can be detected by the application.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               value    counter latch
+ *               cause    irq status bits of channel (M72_INT_xxx)
+ *               time     timestamp of irq
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void FifoPut(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   u_int32      value,
+   u_int32      cause,
+   M72_CNT64    *time	/* nodoc */
+)
+{
+	FIFO *fifo = &llHdl->fifo[ch];
+	M72_FIFO_ENTRY *entry;
+
+	/* FIFO full ? */
+	if (fifo->count == fifo->depth) {
+		fifo->overrun++;
+		fifo->seq++;
+		return;
+	}
+
+	entry = &fifo->buf[fifo->in];
+	entry->value  = value;
+	entry->seq    = fifo->seq++;
+	entry->cause  = cause;
+	entry->time     = time->low;
+	entry->timeHigh = time->high;
+
+	if (++fifo->in == fifo->depth)
+		fifo->in = 0;
+
+	fifo->count++;
+}
+
+/******************************** EvRingPut *********************************
+ *
+ *  Description: Store counter latch of given channel in the event ring
+ *
+ *               Called from M72_Irq. The record is completely written
+ *               before 'head' is incremented (see m72_drv.h).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               value    counter latch
+ *               cause    irq status bits of channel (M72_INT_xxx)
+ *               time     timestamp of irq
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void EvRingPut(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   u_int32      value,
+   u_int32      cause,
+   M72_CNT64    *time	/* nodoc */
+)
+{
+	M72_EVRING *ring = llHdl->evRing;
+	u_int32 head = ring->head;
+	M72_EVRING_REC *rec = &ring->rec[head & llHdl->evRingMask];
+
+	/* invalidate record for readers still copying it */
+	rec->seq     = ~head;
+	M72_EVRING_BARRIER();
+
+	rec->channel = ch;
+	rec->cause   = cause;
+	rec->value   = value;
+	rec->time    = time->low;
+	rec->timeHigh = time->high;
+	rec->seq     = head;
+	M72_EVRING_BARRIER();
+
+	ring->head   = head + 1;
+}
+
+/********************************* FifoRead *********************************
+ *
+ *  Description: Move entries from the FIFO of given channel to a buffer
+ *
+ *               The entries are copied with interrupts enabled. This is
+ *               safe, since M72_Irq never overwrites stored entries.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	       low-level handle
+ *               ch            channel number
+ *               buf           data buffer
+ *               size          data buffer size
+ *  Output.....: nbrRdBytesP   number of read bytes
+ *               return        success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 FifoRead(
+   LL_HANDLE      *llHdl,
+   int32          ch,
+   M72_FIFO_ENTRY *buf,
+   int32          size,
+   int32          *nbrRdBytesP	/* nodoc */
+)
+{
+	FIFO *fifo = &llHdl->fifo[ch];
+	OSS_IRQ_STATE oldState;
+	u_int32 n, nbr, out;
+
+	if (fifo->depth == 0)
+		return(ERR_LL_ILL_PARAM);
+
+	/* number of entries to move */
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	nbr = fifo->count;
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	if (nbr > size / sizeof(M72_FIFO_ENTRY))
+		nbr = size / sizeof(M72_FIFO_ENTRY);
+
+	/* copy entries */
+	for (n=0, out=fifo->out; n<nbr; n++) {
+		buf[n] = fifo->buf[out];
+
+		if (++out == fifo->depth)
+			out = 0;
+	}
+
+	/* release entries */
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	fifo->out    = out;
+	fifo->count -= nbr;
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	DBGWRT_2((DBH, " FIFO: %d entries read\n", nbr));
+
+	*nbrRdBytesP = nbr * sizeof(M72_FIFO_ENTRY);
+
+	return(ERR_SUCCESS);
+}
+
+/********************************* FifoGet **********************************
+ *
+ *  Description: Remove oldest entry from the FIFO of given channel
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *  Output.....: entry    FIFO entry
+ *               return   TRUE=entry removed, FALSE=FIFO empty
+ *  Globals....: -
+ ****************************************************************************/
+static int32 FifoGet(
+   LL_HANDLE      *llHdl,
+   int32          ch,
+   M72_FIFO_ENTRY *entry	/* nodoc */
+)
+{
+	FIFO *fifo = &llHdl->fifo[ch];
+	OSS_IRQ_STATE oldState;
+	int32 got = FALSE;
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	if (fifo->count) {
+		*entry = fifo->buf[fifo->out];
+
+		if (++fifo->out == fifo->depth)
+			fifo->out = 0;
+
+		fifo->count--;
+		got = TRUE;
+	}
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	return(got);
+}
+
+/******************************** MeasStart *********************************
+ *
+ *  Description: Start measurement of given channel
+ *
+ *               Frequency measurement: clear the counter and start the
+ *               gate timer. (see M72_SetStat: M72_FREQ_START)
+ *
+ *               Period/pulse width measurement: force counter clear.
+ *
+ *               Called from M72_SetStat and (for continuous measurement)
+ *               from M72_Irq.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void MeasStart(
+   LL_HANDLE    *llHdl,
+   int32        ch	/* nodoc */
+)
+{
+	switch (llHdl->cntMode[ch]) {
+		case M72_MODE_FREQ:
+			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+					   llHdl->regCountCtrl[ch] | TIMEBASE);
+			break;
+		case M72_MODE_PERIOD:
+		case M72_MODE_PULSEH:
+		case M72_MODE_PULSEL:
+			/* force clear, restore config (see CounterClear) */
+			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+					   (u_int16)((llHdl->regCountCtrl[ch] & ~CLEAR_MASK) |
+								 M72_CLEAR_NOW));
+			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+			break;
+	}
+}
+
+/******************************** Ext64Wrap *********************************
+ *
+ *  Description: Update upper 32 bits of counter at carry/borrow
+ *
+ *               Called from M72_Irq. The Carry/Borrow interrupt doesn't
+ *               tell the direction, so the counter is latched: shortly
+ *               after a carry bit 31 is clear, after a borrow it is set.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Ext64Wrap(
+   LL_HANDLE    *llHdl,
+   int32        ch	/* nodoc */
+)
+{
+	u_int16 high_word;
+
+	/* force latch, restore config (see CounterStore) */
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+			   (u_int16)((llHdl->regCountCtrl[ch] & ~STORE_MASK) |
+						 (M72_STORE_NOW << 4)));
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+
+	high_word = MREAD_D16(llHdl->ma, COUNT_HIGH_REG(ch));
+
+	if (high_word & 0x8000)
+		llHdl->cntHigh[ch]--;		/* borrow */
+	else
+		llHdl->cntHigh[ch]++;		/* carry */
+}
+
+/******************************** Ext64Enable *******************************
+ *
+ *  Description: Enable/disable 64-bit extension of given channel
+ *
+ *               (see M72_SetStat: M72_EXT64)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               enable   0=disable, 1=enable
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Ext64Enable(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   u_int32      enable	/* nodoc */
+)
+{
+	OSS_IRQ_STATE oldState;
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	if (enable) {
+		llHdl->cybwIrq[ch] = M72_CYBW_CYBW;
+		llHdl->regIrqCtrl[ch] &= ~CYBW_MASK;
+		llHdl->regIrqCtrl[ch] |= (u_int16)(M72_CYBW_CYBW << 2);
+		MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(ch), llHdl->regIrqCtrl[ch]);
+	}
+
+	llHdl->ext64[ch]   = enable;
+	llHdl->cntHigh[ch] = 0;
+	IrqActMask(llHdl);
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+}
+
+/******************************** Ext64Read *********************************
+ *
+ *  Description: Read 64-bit counter of given channel
+ *
+ *               The counter is latched with interrupts masked. If a
+ *               carry/borrow is pending (not yet handled by M72_Irq), the
+ *               upper 32 bits are corrected like in Ext64Wrap. The pending
+ *               flag is checked before and after latching; if it changed,
+ *               the counter wrapped meanwhile and is latched again.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *  Output.....: cnt      64-bit counter
+ *  Globals....: -
+ ****************************************************************************/
+static void Ext64Read(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   M72_CNT64    *cnt	/* nodoc */
+)
+{
+	OSS_IRQ_STATE oldState;
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	Ext64Latch(llHdl, ch, cnt);
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+}
+
+/******************************** Ext64Latch ********************************
+ *
+ *  Description: Latch 64-bit counter of given channel
+ *
+ *               (see Ext64Read). Must be called with interrupts masked or
+ *               from M72_Irq.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *  Output.....: cnt      64-bit counter
+ *  Globals....: -
+ ****************************************************************************/
+static void Ext64Latch(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   M72_CNT64    *cnt	/* nodoc */
+)
+{
+	u_int32 stateReg = (ch < 2) ? IRQ_STATE_REG1 : IRQ_STATE_REG2;
+	u_int32 pendBit  = CYBW_PEND(ch & 1);
+	u_int32 pend1, pend2, low, high;
+
+	do {
+		pend1 = MREAD_D16(llHdl->ma, stateReg) & pendBit;
+
+		/* force latch, restore config */
+		MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+				   (u_int16)((llHdl->regCountCtrl[ch] & ~STORE_MASK) |
+							 (M72_STORE_NOW << 4)));
+		MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+
+		low  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(ch));
+		low |= (u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(ch)) << 16;
+
+		pend2 = MREAD_D16(llHdl->ma, stateReg) & pendBit;
+	} while (pend1 != pend2);
+
+	high = llHdl->cntHigh[ch];
+
+	/* carry/borrow not yet handled by M72_Irq */
+	if (pend2) {
+		if (low & 0x80000000)
+			high--;
+		else
+			high++;
+	}
+
+	cnt->low  = low;
+	cnt->high = high;
+}
+
+/******************************** EvQueuePut ********************************
+ *
+ *  Description: Store counter latch of given channel in the event queue
+ *
+ *               Called from M72_Irq. If the queue is full, the entry is
+ *               dropped and the overrun counter is incremented. The
+ *               sequence number is incremented in any case.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               value    counter latch
+ *               cause    irq status bits of channel (M72_INT_xxx)
+ *               time     timestamp of irq
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void EvQueuePut(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   u_int32      value,
+   u_int32      cause,
+   M72_CNT64    *time	/* nodoc */
+)
+{
+	EVQUEUE *evq = &llHdl->evq;
+	M72_EVENT *entry;
+
+	/* queue full ? */
+	if (evq->count == evq->depth) {
+		evq->overrun++;
+		evq->seq++;
+		return;
+	}
+
+	entry = &evq->buf[evq->in];
+	entry->channel = ch;
+	entry->cause   = cause;
+	entry->value   = value;
+	entry->seq     = evq->seq++;
+	entry->time    = time->low;
+	entry->timeHigh = time->high;
+
+	if (++evq->in == evq->depth)
+		evq->in = 0;
+
+	evq->count++;
+}
+
+/******************************** EvQueueRead *******************************
+ *
+ *  Description: Move entries from the event queue to a buffer
+ *
+ *               If the queue is empty, wait for an event with the read
+ *               timeout of the given channel. The entries are copied with
+ *               interrupts enabled (see FifoRead).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	       low-level handle
+ *               ch            channel number (read timeout)
+ *               buf           data buffer
+ *               size          data buffer size
+ *  Output.....: nbrRdBytesP   number of read bytes
+ *               return        success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 EvQueueRead(
+   LL_HANDLE      *llHdl,
+   int32          ch,
+   M72_EVENT      *buf,
+   int32          size,
+   int32          *nbrRdBytesP	/* nodoc */
+)
+{
+	EVQUEUE *evq = &llHdl->evq;
+	OSS_IRQ_STATE oldState;
+	u_int32 n, nbr, out;
+	int32 error;
+
+	if (evq->depth == 0)
+		return(ERR_LL_ILL_PARAM);
+
+	if (size < (int32)sizeof(M72_EVENT))
+		return(ERR_LL_USERBUF);
+
+	/*----------------------------+
+	|  wait for event             |
+	+----------------------------*/
+	for (;;) {
+		oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+		nbr = evq->count;
+		OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+		if (nbr)
+			break;
+
+		DBGWRT_2((DBH, " wait for event ..\n"));
+
+		if ((error = OSS_SemWait(llHdl->osHdl, evq->semHdl,
+								 llHdl->readTimeout[ch])))
+			return(error);
+	}
+
+	if (nbr > size / sizeof(M72_EVENT))
+		nbr = size / sizeof(M72_EVENT);
+
+	/* copy entries */
+	for (n=0, out=evq->out; n<nbr; n++) {
+		buf[n] = evq->buf[out];
+
+		if (++out == evq->depth)
+			out = 0;
+	}
+
+	/* release entries */
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	evq->out    = out;
+	evq->count -= nbr;
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	DBGWRT_2((DBH, " event queue: %d entries read\n", nbr));
+
+	*nbrRdBytesP = nbr * sizeof(M72_EVENT);
+
+	return(ERR_SUCCESS);
+}
+
+/******************************* SetStatList ********************************
+ *
+ *  Description: Execute a list of setstats as one transaction
+ *
+ *               (see M72_SetStat: M72_BLK_SETSTAT_LIST)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               list     setstat list
+ *               nbr      number of list entries
+ *  Output.....: return   success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 SetStatList(
+   LL_HANDLE         *llHdl,
+   M72_SETSTAT_ENTRY *list,
+   u_int32           nbr	/* nodoc */
+)
+{
+	M72_SETSTAT_ENTRY *entry;
+	OSS_IRQ_STATE oldState;
+	u_int32 dirty[CH_NUMBER], dirtyAll = 0, outSet = 0;
+	u_int32 n, ch;
+	int32 value, error;
+
+	DBGWRT_2((DBH, " setstat list: %d entries\n", nbr));
+
+	/*----------------------------+
+	|  check all entries          |
+	+----------------------------*/
+	for (n=0, entry=list; n<nbr; n++, entry++) {
+		if ((error = SetStatListCheck(llHdl, entry))) {
+			DBGWRT_ERR((DBH, " *** M72_SetStat: setstat list entry %d "
+						"(ch=%d code=0x%04x value=0x%x) invalid\n",
+						n, entry->ch, entry->code, entry->value));
+			return(error);
+		}
+	}
+
+	for (ch=0; ch<CH_NUMBER; ch++)
+		dirty[ch] = 0;
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	/*----------------------------+
+	|  update shadow registers    |
+	+----------------------------*/
+	for (n=0, entry=list; n<nbr; n++, entry++) {
+		ch    = entry->ch;
+		value = entry->value;
+
+		switch (entry->code) {
+			case M72_CNT_MODE:
+				llHdl->cntMode[ch] = value;
+				llHdl->continuous[ch] = FALSE;
+				if (llHdl->cam[ch].mode == M72_CAM_SEQ)
+					llHdl->cam[ch].mode = M72_CAM_OFF;
+				if (llHdl->tbChan == ch)
+					llHdl->tbChan = M72_TIMEBASE_OFF;
+				llHdl->regCountCtrl[ch] &= ~MODE_MASK;
+				llHdl->regCountCtrl[ch] |= (u_int16)(value << 8);
+				dirty[ch] |= DIRTY_COUNT_CTRL;
+				break;
+			case M72_CNT_PRELOAD:
+				if (value == M72_PRELOAD_NOW) {
+					dirty[ch] |= DO_PRELOAD_NOW;
+					break;
+				}
+				llHdl->cntPreload[ch] = value;
+				llHdl->regCountCtrl[ch] &= ~PRELOAD_MASK;
+				llHdl->regCountCtrl[ch] |= (u_int16)(value << 2);
+				dirty[ch] |= DIRTY_COUNT_CTRL;
+				break;
+			case M72_CNT_CLEAR:
+				if (value == M72_CLEAR_NOW) {
+					dirty[ch] |= DO_CLEAR_NOW;
+					break;
+				}
+				llHdl->cntClear[ch] = value;
+				llHdl->regCountCtrl[ch] &= ~CLEAR_MASK;
+				llHdl->regCountCtrl[ch] |= (u_int16)(value << 0);
+				dirty[ch] |= DIRTY_COUNT_CTRL;
+				break;
+			case M72_CNT_STORE:
+				if (value == M72_STORE_NOW) {
+					dirty[ch] |= DO_STORE_NOW;
+					break;
+				}
+				llHdl->cntStore[ch] = value;
+				llHdl->regCountCtrl[ch] &= ~STORE_MASK;
+				llHdl->regCountCtrl[ch] |= (u_int16)(value << 4);
+				dirty[ch] |= DIRTY_COUNT_CTRL;
+				if (value != M72_STORE_IN2)
+					llHdl->capture[ch] = FALSE;
+				break;
+			case M72_TIMER_START:
+				llHdl->timerStart[ch] = value;
+				llHdl->regCountCtrl[ch] &= ~TIMER;
+				llHdl->regCountCtrl[ch] |= (u_int16)(value << 7);
+				dirty[ch] |= DIRTY_COUNT_CTRL;
+				break;
+			case M72_ENB_IRQ:
+				llHdl->enbIrq[ch] = value;
+				IrqEnbMask(llHdl);
+				llHdl->regIrqCtrl[ch] &= ~ENB_MASK;
+				llHdl->regIrqCtrl[ch] |= (u_int16)(value << 7);
+				dirty[ch] |= DIRTY_IRQ_CTRL;
+
+				if (value == 0) {
+					llHdl->regIntStatChan[ch] = 0;
+					if (llHdl->tbChan == ch)
+						llHdl->tbChan = M72_TIMEBASE_OFF;
+				}
+				break;
+			case M72_COMP_IRQ:
+				llHdl->compIrq[ch] = value;
+				llHdl->regIrqCtrl[ch] &= ~COMP_MASK;
+				llHdl->regIrqCtrl[ch] |= (u_int16)(value << 4);
+				dirty[ch] |= DIRTY_IRQ_CTRL;
+				break;
+			case M72_CYBW_IRQ:
+				llHdl->cybwIrq[ch] = value;
+				llHdl->regIrqCtrl[ch] &= ~CYBW_MASK;
+				llHdl->regIrqCtrl[ch] |= (u_int16)(value << 2);
+				dirty[ch] |= DIRTY_IRQ_CTRL;
+				break;
+			case M72_LBREAK_IRQ:
+				llHdl->lbreakIrq[ch] = value;
+				llHdl->regIrqCtrl[ch] &= ~LBREAK_ENB;
+				llHdl->regIrqCtrl[ch] |= (u_int16)(value << 0);
+				dirty[ch] |= DIRTY_IRQ_CTRL;
+				break;
+			case M72_XIN2_IRQ:
+				llHdl->xin2Irq[ch] = value;
+				llHdl->regIrqCtrl[ch] &= ~XIN2_ENB;
+				llHdl->regIrqCtrl[ch] |= (u_int16)(value << 1);
+				dirty[ch] |= DIRTY_IRQ_CTRL;
+				if (!value)
+					llHdl->capture[ch] = FALSE;
+				break;
+			case M72_VAL_COMPA:
+				llHdl->valCompA[ch] = value;
+				dirty[ch] |= DIRTY_COMPA;
+				break;
+			case M72_VAL_COMPB:
+				llHdl->valCompB[ch] = value;
+				dirty[ch] |= DIRTY_COMPB;
+				break;
+			case M72_READ_MODE:
+				llHdl->readMode[ch] = value;
+				break;
+			case M72_READ_TIMEOUT:
+				llHdl->readTimeout[ch] = value;
+				break;
+			case M72_WRITE_MODE:
+				llHdl->writeMode[ch] = value;
+				break;
+			case M72_BLKREAD_MODE:
+				llHdl->blkReadMode[ch] = value;
+				break;
+			case M72_FIFO_EVENTS:
+				llHdl->fifo[ch].events = value;
+				break;
+			case M72_OUT_MODE:
+				llHdl->regOutCtrl1 = (u_int16)(value & 0xffff);
+				llHdl->regOutCtrl2 = (u_int16)(value >> 16);
+				dirtyAll |= DIRTY_OUT_CTRL;
+				break;
+			case M72_OUT_SET:
+				outSet = value;
+				dirtyAll |= DIRTY_OUT_SET;
+				break;
+		}
+	}
+
+	/*----------------------------+
+	|  write modified registers   |
+	+----------------------------*/
+	for (ch=0; ch<CH_NUMBER; ch++) {
+		if (dirty[ch] & DIRTY_COMPA) {
+			MWRITE_D16(llHdl->ma, COMPA_LOW_REG(ch),  (u_int16)(llHdl->valCompA[ch] & 0xffff));
+			MWRITE_D16(llHdl->ma, COMPA_HIGH_REG(ch), (u_int16)(llHdl->valCompA[ch] >> 16));
+		}
+		if (dirty[ch] & DIRTY_COMPB) {
+			MWRITE_D16(llHdl->ma, COMPB_LOW_REG(ch),  (u_int16)(llHdl->valCompB[ch] & 0xffff));
+			MWRITE_D16(llHdl->ma, COMPB_HIGH_REG(ch), (u_int16)(llHdl->valCompB[ch] >> 16));
+		}
+		if (dirty[ch] & DIRTY_COUNT_CTRL)
+			MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+		if (dirty[ch] & DIRTY_IRQ_CTRL)
+			MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(ch), llHdl->regIrqCtrl[ch]);
+	}
+
+	if (dirtyAll & DIRTY_OUT_CTRL) {
+		MWRITE_D16(llHdl->ma, OUT_CTRL1_REG, llHdl->regOutCtrl1);
+		MWRITE_D16(llHdl->ma, OUT_CTRL2_REG, llHdl->regOutCtrl2);
+	}
+	if (dirtyAll & DIRTY_OUT_SET)
+		MWRITE_D16(llHdl->ma, OUT_CONFIG_REG, (u_int16)(outSet & 0xf));
+
+	/*----------------------------+
+	|  forced actions             |
+	+----------------------------*/
+	for (ch=0; ch<CH_NUMBER; ch++) {
+		if (dirty[ch] & DO_CLEAR_NOW)
+			CounterClear(llHdl, ch, M72_CLEAR_NOW);
+		if (dirty[ch] & DO_PRELOAD_NOW)
+			CounterLoad(llHdl, ch, M72_PRELOAD_NOW);
+		if (dirty[ch] & DO_STORE_NOW)
+			CounterStore(llHdl, ch, M72_STORE_NOW);
+	}
+
+	/* read mode, FIFO events, counter mode may be changed */
+	IrqActMask(llHdl);
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	return(ERR_SUCCESS);
+}
+
+/***************************** SetStatListCheck *****************************
+ *
+ *  Description: Check one entry of a setstat list
+ *
+ *               The value ranges are the same as for the single setstats.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               entry    setstat list entry
+ *  Output.....: return   success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 SetStatListCheck(
+   LL_HANDLE         *llHdl,
+   M72_SETSTAT_ENTRY *entry	/* nodoc */
+)
+{
+	int32 value = entry->value;
+
+	if (entry->ch >= CH_NUMBER)
+		return(ERR_LL_ILL_CHAN);
+
+	switch (entry->code) {
+		case M72_CNT_MODE:
+			if (!IN_RANGE(value,0,10) || value == 8)
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_CNT_PRELOAD:
+		case M72_CNT_CLEAR:
+			if (!IN_RANGE(value,0,3))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_CNT_STORE:
+			if (!IN_RANGE(value,0,2))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_READ_MODE:
+			if (!IN_RANGE(value,0,3))
+				return(ERR_LL_ILL_PARAM);
+			if (value == M72_READ_QUEUE && llHdl->fifo[entry->ch].depth == 0)
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_TIMER_START:
+		case M72_ENB_IRQ:
+		case M72_LBREAK_IRQ:
+		case M72_XIN2_IRQ:
+			if (!IN_RANGE(value,0,1))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_BLKREAD_MODE:
+			if (!IN_RANGE(value,0,2))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_COMP_IRQ:
+			if (!IN_RANGE(value,0,5))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_CYBW_IRQ:
+			if (!IN_RANGE(value,0,3))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_WRITE_MODE:
+			if (value != 0 && value != 2)
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_FIFO_EVENTS:
+			if (!IN_RANGE(value,0,CHAN_PEND_MASK))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_OUT_SET:
+			if (!IN_RANGE(value,0,0x0f))
+				return(ERR_LL_ILL_PARAM);
+			break;
+		case M72_VAL_COMPA:
+		case M72_VAL_COMPB:
+		case M72_READ_TIMEOUT:
+		case M72_OUT_MODE:
+			break;
+		default:
+			return(ERR_LL_UNK_CODE);
+	}
+
+	return(ERR_SUCCESS);
+}
+
+/******************************** ConfigGet *********************************
+ *
+ *  Description: Copy configuration of all channels
+ *
+ *               (see M72_GetStat: M72_BLK_CONFIG)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: cfg      configuration snapshot
+ *  Globals....: -
+ ****************************************************************************/
+static void ConfigGet(
+   LL_HANDLE    *llHdl,
+   M72_CONFIG   *cfg	/* nodoc */
+)
+{
+	OSS_IRQ_STATE oldState;
+	M72_CONFIG_CHAN *chan;
+	u_int32 n;
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	cfg->version     = M72_CONFIG_VERSION;
+	cfg->size        = sizeof(M72_CONFIG);
+	cfg->irqCount    = llHdl->irqCount;
+	cfg->regOutCtrl1 = llHdl->regOutCtrl1;
+	cfg->regOutCtrl2 = llHdl->regOutCtrl2;
+	cfg->timebase    = llHdl->tbChan;
+
+	for (n=0; n<CH_NUMBER; n++) {
+		chan = &cfg->chan[n];
+		chan->cntMode      = llHdl->cntMode[n];
+		chan->cntPreload   = llHdl->cntPreload[n];
+		chan->cntClear     = llHdl->cntClear[n];
+		chan->cntStore     = llHdl->cntStore[n];
+		chan->timerStart   = llHdl->timerStart[n];
+		chan->enbIrq       = llHdl->enbIrq[n];
+		chan->compIrq      = llHdl->compIrq[n];
+		chan->cybwIrq      = llHdl->cybwIrq[n];
+		chan->lbreakIrq    = llHdl->lbreakIrq[n];
+		chan->xin2Irq      = llHdl->xin2Irq[n];
+		chan->valPreload   = llHdl->valPreload[n];
+		chan->valCompA     = llHdl->valCompA[n];
+		chan->valCompB     = llHdl->valCompB[n];
+		chan->readMode     = llHdl->readMode[n];
+		chan->readTimeout  = llHdl->readTimeout[n];
+		chan->writeMode    = llHdl->writeMode[n];
+		chan->blkReadMode  = llHdl->blkReadMode[n];
+		chan->fifoEvents   = llHdl->fifo[n].events;
+		chan->fifoDepth    = llHdl->fifo[n].depth;
+		chan->regCountCtrl = llHdl->regCountCtrl[n];
+		chan->regIrqCtrl   = llHdl->regIrqCtrl[n];
+		chan->intStatChan  = llHdl->regIntStatChan[n];
+		chan->continuous   = llHdl->continuous[n];
+		chan->ext64        = llHdl->ext64[n];
+		chan->capture      = llHdl->capture[n];
+		chan->camMode      = llHdl->cam[n].mode;
+	}
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+}
+
+/******************************** CamLoad ***********************************
+ *
+ *  Description: Load comparator cam table of given channel
+ *
+ *               (see M72_SetStat: M72_BLK_CAM)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               tbl      cam table
+ *               size     size of cam table [bytes]
+ *  Output.....: return   success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 CamLoad(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   M72_CAM      *tbl,
+   u_int32      size	/* nodoc */
+)
+{
+	/*--------------------+
+	|  check table        |
+	+--------------------*/
+	if (size < M72_CAM_SIZE(1))
+		return(ERR_LL_USERBUF);
+
+	if (tbl->mode > M72_CAM_INCR || tbl->loop > 1)
+		return(ERR_LL_ILL_PARAM);
+
+	if (tbl->mode != M72_CAM_OFF) {
+		if (tbl->count < 1 || tbl->count > CAM_SIZE_MAX)
+			return(ERR_LL_ILL_PARAM);
+
+		if (size < M72_CAM_SIZE(tbl->count))
+			return(ERR_LL_USERBUF);
+	}
+
+	DBGWRT_2((DBH, " channel %d: cam mode=%d count=%d\n",
+			  ch, tbl->mode, tbl->count));
+
+	return( CamSet(llHdl, ch, tbl->mode, tbl->loop, tbl->incr, tbl->count,
+				   tbl->table) );
+}
+
+/******************************** SeqLoad ***********************************
+ *
+ *  Description: Start timer interval sequence of given channel
+ *
+ *               (see M72_SetStat: M72_BLK_SEQ)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               seq      interval sequence
+ *               size     size of interval sequence [bytes]
+ *  Output.....: return   success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 SeqLoad(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   M72_SEQ      *seq,
+   u_int32      size	/* nodoc */
+)
+{
+	OSS_IRQ_STATE oldState;
+	int32 error;
+
+	/*--------------------+
+	|  check sequence     |
+	+--------------------*/
+	if (size < M72_SEQ_SIZE(1))
+		return(ERR_LL_USERBUF);
+
+	if (seq->count > CAM_SIZE_MAX || seq->loop > 1 ||
+		llHdl->cntMode[ch] != M72_MODE_TIMER)
+		return(ERR_LL_ILL_PARAM);
+
+	if (size < M72_SEQ_SIZE(seq->count))
+		return(ERR_LL_USERBUF);
+
+	DBGWRT_2((DBH, " channel %d: sequence count=%d loop=%d\n",
+			  ch, seq->count, seq->loop));
+
+	/* stop sequence */
+	if (seq->count == 0)
+		return( CamSet(llHdl, ch, M72_CAM_OFF, 0, 0, 0, NULL) );
+
+	/*--------------------+
+	|  config timer       |
+	+--------------------*/
+	/* shadow registers are also changed by M72_Irq */
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	CounterClear(llHdl, ch, M72_CLEAR_COMP);
+
+	llHdl->compIrq[ch] = M72_COMP_EQUAL;
+	llHdl->regIrqCtrl[ch] &= ~COMP_MASK;
+	llHdl->regIrqCtrl[ch] |= (u_int16)(M72_COMP_EQUAL << 4);
+	MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(ch), llHdl->regIrqCtrl[ch]);
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	/*--------------------+
+	|  start sequence     |
+	+--------------------*/
+	if ((error = CamSet(llHdl, ch, M72_CAM_SEQ, seq->loop, 0, seq->count,
+						seq->interval)))
+		return(error);
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	CounterClear(llHdl, ch, M72_CLEAR_NOW);
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	return(ERR_SUCCESS);
+}
+
+/******************************** CamSet ************************************
+ *
+ *  Description: Replace compare table of given channel
+ *
+ *               The table is copied and the first entry is written to
+ *               comparator A.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               mode     M72_CAM_xxx or M72_CAM_SEQ
+ *               loop     restart table at end
+ *               incr     increment (M72_CAM_INCR)
+ *               count    number of table entries
+ *               table    table entries
+ *  Output.....: return   success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 CamSet(
+   LL_HANDLE    *llHdl,
+   int32        ch,
+   u_int32      mode,
+   u_int32      loop,
+   u_int32      incr,
+   u_int32      count,
+   u_int32      *table	/* nodoc */
+)
+{
+	CAM *cam = &llHdl->cam[ch];
+	OSS_IRQ_STATE oldState;
+	u_int32 *buf = NULL, *oldBuf;
+	u_int32 bufSize = 0, oldSize;
+
+	/*--------------------+
+	|  copy table         |
+	+--------------------*/
+	if (mode == M72_CAM_LIST || mode == M72_CAM_SEQ) {
+		if ((buf = (u_int32*)OSS_MemGet(llHdl->osHdl, count * sizeof(u_int32),
+										&bufSize)) == NULL)
+			return(ERR_OSS_MEM_ALLOC);
+
+		OSS_MemCopy(llHdl->osHdl, count * sizeof(u_int32),
+					(char*)table, (char*)buf);
+	}
+
+	/*--------------------+
+	|  replace table      |
+	+--------------------*/
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	oldBuf  = cam->buf;
+	oldSize = cam->bufSize;
+
+	cam->buf      = buf;
+	cam->bufSize  = bufSize;
+	cam->mode     = mode;
+	cam->loop     = loop;
+	cam->incr     = incr;
+	cam->count    = count;
+	cam->idx      = 1;
+	cam->matches  = 0;
+	cam->underrun = 0;
+	IrqActMask(llHdl);
+
+	/* first entry */
+	if (mode != M72_CAM_OFF) {
+		llHdl->valCompA[ch] = table[0];
+		MWRITE_D16(llHdl->ma, COMPA_LOW_REG(ch),  (u_int16)(llHdl->valCompA[ch] & 0xffff));
+		MWRITE_D16(llHdl->ma, COMPA_HIGH_REG(ch), (u_int16)(llHdl->valCompA[ch] >> 16));
+	}
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	if (oldBuf)
+		OSS_MemFree(llHdl->osHdl, (int8*)oldBuf, oldSize);
+
+	return(ERR_SUCCESS);
+}
+
+/******************************** CamNext ***********************************
+ *
+ *  Description: Write next cam position of given channel to comparator A
+ *
+ *               Called from M72_Irq at the Comparator interrupt. For an
+ *               interval sequence, a late interval is restarted and the
+ *               counter is halted at the end of the sequence.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void CamNext(
+   LL_HANDLE    *llHdl,
+   int32        ch		/* nodoc */
+)
+{
+	CAM *cam = &llHdl->cam[ch];
+	u_int32 val, cnt;
+
+	cam->matches++;
+
+	if (cam->mode == M72_CAM_INCR) {
+		val = llHdl->valCompA[ch] + cam->incr;
+	}
+	else {
+		/* end of table ? */
+		if (cam->idx >= cam->count) {
+			if (!cam->loop) {
+				/* end of sequence: halt timer */
+				if (cam->mode == M72_CAM_SEQ) {
+					cam->mode = M72_CAM_OFF;
+					llHdl->cntMode[ch] = M72_MODE_NO;
+					llHdl->regCountCtrl[ch] &= ~MODE_MASK;
+					MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+							   llHdl->regCountCtrl[ch]);
+				}
+				return;
+			}
+			cam->idx = 0;
+		}
+		val = cam->buf[cam->idx++];
+	}
+
+	llHdl->valCompA[ch] = val;
+	MWRITE_D16(llHdl->ma, COMPA_LOW_REG(ch),  (u_int16)(val & 0xffff));
+	MWRITE_D16(llHdl->ma, COMPA_HIGH_REG(ch), (u_int16)(val >> 16));
+
+	if (cam->mode != M72_CAM_SEQ)
+		return;
+
+	/* interval already elapsed ? (force latch, restore config) */
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+			   (u_int16)((llHdl->regCountCtrl[ch] & ~STORE_MASK) |
+						 (M72_STORE_NOW << 4)));
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+
+	cnt  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(ch));
+	cnt |= (u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(ch)) << 16;
+
+	if (cnt >= val) {
+		/* restart interval (force clear, restore config) */
+		cam->underrun++;
+		MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+				   (u_int16)((llHdl->regCountCtrl[ch] & ~CLEAR_MASK) |
+							 M72_CLEAR_NOW));
+		MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+	}
+}
+
+/********************************* IrqWork **********************************
+ *
+ *  Description: OS-level interrupt work (see M72_Irq)
+ *
+ *               Stores the events in the FIFOs, the event ring and the
+ *               event queue, stores the time of the events, releases the
+ *               read/event queue semaphores and sends the installed signals.
+ *
+ *               Called by M72_Irq or deferred by IrqDefer (with lock, since
+ *               the interrupt may occur meanwhile).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               work     irq work
+ *               lock     mask interrupt while storing events
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void IrqWork(
+   LL_HANDLE    *llHdl,
+   IRQ_WORK     *work,
+   u_int32      lock	/* nodoc */
+)
+{
+	u_int32 n, i, pend, cause, store, queued = FALSE;
+	u_int32 irq_state = work->irqState;
+	OSS_IRQ_STATE oldState;
+	M72_CNT64 stamp;
+
+	stamp.low  = work->stampLow;
+	stamp.high = work->stampHigh;
+
+	if (lock)
+		oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	/* store events of channels with pending bits */
+	for (pend = irq_state; pend; pend &= ~(CHAN_PEND_MASK << (n<<3))) {
+		n = FIRST_BIT(pend) >> 3;
+		cause = (irq_state >> (n<<3)) & CHAN_PEND_MASK;
+		store = ((work->fifoStore >> n) & 1 ? STORE_FIFO : 0) |
+				((work->evStore >> n) & 1 ? STORE_EV : 0);
+
+		/* store time of irq events */
+		for (i=cause; i; i &= i - 1)
+			llHdl->evTime[n][FIRST_BIT(i)] = stamp.low;
+
+		queued |= IrqStore(llHdl, n, cause, store, work->value[n], &stamp);
+
+		/* values dropped by DeferPut (queue full) */
+		if (work->fifoLost[n] && llHdl->fifo[n].depth) {
+			llHdl->fifo[n].overrun += work->fifoLost[n];
+			llHdl->fifo[n].seq     += work->fifoLost[n];
+		}
+		if (work->evLost[n] && llHdl->evq.depth) {
+			llHdl->evq.overrun += work->evLost[n];
+			llHdl->evq.seq     += work->evLost[n];
+		}
+	}
+
+	if (lock)
+		OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	/* wake up reads */
+	for (pend = irq_state; pend; pend &= ~(CHAN_PEND_MASK << (n<<3))) {
+		n = FIRST_BIT(pend) >> 3;
+		cause = (irq_state >> (n<<3)) & CHAN_PEND_MASK;
+
+		IrqWake(llHdl, n, cause, (work->fifoStore >> n) & 1 ? STORE_FIFO : 0);
+	}
+
+	/* send signals if installed */
+	for (pend = irq_state & llHdl->sigPend; pend; pend &= pend - 1) {
+		i = FIRST_BIT(pend);
+		OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[i >> 3][i & 7]);
+	}
+
+	/* wake up event queue reader */
+	if (queued)
+		OSS_SemSignal(llHdl->osHdl, llHdl->evq.semHdl);
+}
+
+/********************************* IrqStore *********************************
+ *
+ *  Description: Store counter latch of given channel in the FIFO, the
+ *               event ring and the event queue (see IrqWork)
+ *
+ *               Called by M72_Irq or IrqWork (with interrupt masked).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               cause    irq status bits of channel (M72_INT_xxx)
+ *               store    storage of counter latch (STORE_xxx)
+ *               value    counter latch
+ *               stamp    timestamp of irq
+ *  Output.....: return   event queue entry stored (TRUE/FALSE)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 IrqStore(
+   LL_HANDLE    *llHdl,
+   u_int32      ch,
+   u_int32      cause,
+   u_int32      store,
+   u_int32      value,
+   M72_CNT64    *stamp	/* nodoc */
+)
+{
+	u_int32 queued = FALSE;
+
+	if (store & STORE_FIFO)
+		FifoPut(llHdl, ch, value, cause, stamp);
+
+	if (store & STORE_EV) {
+		if (llHdl->evRing)
+			EvRingPut(llHdl, ch, value, cause, stamp);
+		if (llHdl->evq.depth) {
+			EvQueuePut(llHdl, ch, value, cause, stamp);
+			queued = TRUE;
+		}
+	}
+
+	return(queued);
+}
+
+/********************************* IrqWake **********************************
+ *
+ *  Description: Release the read semaphore of given channel (see IrqWork)
+ *
+ *               Queued read: new FIFO entry, waiting read: Ready irq.
+ *               Called by M72_Irq or IrqWork (interrupt not masked).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               ch       channel number
+ *               cause    irq status bits of channel (M72_INT_xxx)
+ *               store    storage of counter latch (STORE_xxx)
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void IrqWake(
+   LL_HANDLE    *llHdl,
+   u_int32      ch,
+   u_int32      cause,
+   u_int32      store	/* nodoc */
+)
+{
+	if ((llHdl->readMode[ch] == M72_READ_QUEUE && (store & STORE_FIFO)) ||
+		(llHdl->readMode[ch] == M72_READ_WAIT && (cause & M72_INT_READY)))
+		OSS_SemSignal(llHdl->osHdl, llHdl->readSemHdl[ch]);
+}
+
+/********************************* DeferNext ********************************
+ *
+ *  Description: Get storage for the irq work of M72_Irq
+ *
+ *               The next queue entry is filled in place and published by
+ *               DeferPut. When the queue is full, the spare entry is used
+ *               and merged by DeferPut.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: return   irq work
+ *  Globals....: -
+ ****************************************************************************/
+static IRQ_WORK *DeferNext(
+   LL_HANDLE    *llHdl	/* nodoc */
+)
+{
+	DEFER *defer = &llHdl->defer;
+
+	if (defer->in - defer->out < DEFER_DEPTH)
+		return(&defer->buf[defer->in & (DEFER_DEPTH - 1)]);
+
+	return(&defer->spare);
+}
+
+/********************************* DeferPut *********************************
+ *
+ *  Description: Queue irq work for IrqDefer (called by M72_Irq)
+ *
+ *               When the queue is full, the work is merged into the last
+ *               entry per channel: the pending flags and the counter value
+ *               of a channel are only taken if the entry has no pending
+ *               flags for the channel, so a value is never stored with the
+ *               flags of another interrupt. Otherwise the channel's part is
+ *               dropped: its values are counted as lost (IrqWork adds them
+ *               to the overrun counters and sequence numbers of the FIFO and
+ *               the event queue), its signals and read wake-ups are lost
+ *               and counted by M72_DEFER_OVERRUN.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               work     irq work (see DeferNext)
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void DeferPut(
+   LL_HANDLE    *llHdl,
+   IRQ_WORK     *work	/* nodoc */
+)
+{
+	DEFER *defer = &llHdl->defer;
+	IRQ_WORK *next, *last;
+	u_int32 n, chMask, dropped = FALSE;
+
+	/* queue not full ? */
+	if (defer->in - defer->out < DEFER_DEPTH) {
+		next = &defer->buf[defer->in & (DEFER_DEPTH - 1)];
+
+		/* filled in place (see DeferNext) */
+		if (work != next)
+			*next = *work;
+		defer->in++;
+		return;
+	}
+
+	/* merge into last entry */
+	last = &defer->buf[(defer->in - 1) & (DEFER_DEPTH - 1)];
+
+	for (n=0; n<CH_NUMBER; n++) {
+		chMask = CHAN_PEND_MASK << (n<<3);
+
+		if (!(work->irqState & chMask))
+			continue;
+
+		/* channel free in last entry: take flags and value */
+		if (!(last->irqState & chMask)) {
+			last->irqState  |= work->irqState & chMask;
+			last->value[n]   = work->value[n];
+			last->fifoStore |= work->fifoStore & (1 << n);
+			last->evStore   |= work->evStore & (1 << n);
+			continue;
+		}
+
+		/* drop channel's part */
+		last->fifoLost[n] += (work->fifoStore >> n) & 1;
+		last->evLost[n]   += (work->evStore >> n) & 1;
+		dropped = TRUE;
+	}
+
+	if (dropped)
+		defer->overrun++;
+}
+
+/********************************* IrqDefer *********************************
+ *
+ *  Description: Cyclic alarm routine: execute the deferred irq work
+ *
+ *               The queued irq work is executed in the order of the
+ *               interrupts. The queue is owned (busy) while executing,
+ *               a flush by DeferSet waits for it.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: arg	  low-level handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void IrqDefer(
+   void *arg	/* nodoc */
+)
+{
+	LL_HANDLE *llHdl = (LL_HANDLE*)arg;
+	DEFER *defer = &llHdl->defer;
+	IRQ_WORK work;
+	OSS_IRQ_STATE oldState;
+
+	/* queue owned by DeferSet ? */
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	if (defer->busy) {
+		OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+		return;
+	}
+	defer->busy = TRUE;
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	for (;;) {
+		/* get next entry */
+		oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+		if (defer->in == defer->out) {
+			defer->busy = FALSE;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+			break;
+		}
+
+		work = defer->buf[defer->out & (DEFER_DEPTH - 1)];
+		defer->out++;
+
+		OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+		IrqWork(llHdl, &work, TRUE);
+	}
+}
+
+/********************************* DeferSet *********************************
+ *
+ *  Description: Enable/disable deferred irq work
+ *
+ *               (see M72_SetStat: M72_IRQ_DEFER)
+ *               When disabled, the queued work is executed before the
+ *               interrupt service routine does the work again directly.
+ *               A running IrqDefer (other CPU) is waited for, so the work
+ *               is never executed by two routines at once.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               period   alarm period [ms] (0=disable)
+ *  Output.....: return   success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 DeferSet(
+   LL_HANDLE    *llHdl,
+   u_int32      period	/* nodoc */
+)
+{
+	DEFER *defer = &llHdl->defer;
+	IRQ_WORK work;
+	OSS_IRQ_STATE oldState;
+	u_int32 realMsec;
+	int32 error;
+
+	DBGWRT_1((DBH, " deferred irq work: period=%d ms\n", period));
+
+	/* stop alarm */
+	if (defer->period)
+		OSS_AlarmClear(llHdl->osHdl, defer->alarmHdl);
+
+	/*--------------------+
+	 |  disable           |
+	 +--------------------*/
+	if (period == 0) {
+		/* wait for running IrqDefer, own queue */
+		for (;;) {
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			if (!defer->busy)
+				break;
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+			OSS_Delay(llHdl->osHdl, 1);
+		}
+
+		/* flush queue (in order) */
+		while (defer->in != defer->out) {
+			work = defer->buf[defer->out & (DEFER_DEPTH - 1)];
+			defer->out++;
+			IrqWork(llHdl, &work, FALSE);
+		}
+		defer->period = 0;
+
+		OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+		return(ERR_SUCCESS);
+	}
+
+	/*--------------------+
+	 |  enable            |
+	 +--------------------*/
+	if (defer->alarmHdl == NULL &&
+		(error = OSS_AlarmCreate(llHdl->osHdl, IrqDefer, (void*)llHdl,
+								 &defer->alarmHdl)))
+		return(error);
+
+	if ((error = OSS_AlarmSet(llHdl->osHdl, defer->alarmHdl, period, TRUE,
+							  &realMsec))) {
+		/* back to direct work */
+		DeferSet(llHdl, 0);
+		return(error);
+	}
+
+	defer->period = realMsec ? realMsec : period;
+
+	return(ERR_SUCCESS);
+}
+
+#ifdef M72_IRQ_PROFILE
+/********************************* ProfTime *********************************
+ *
+ *  Description: Get time for the ISR profile
+ *
+ *               Latches the lower 32 bits of the timebase channel (must
+ *               be set). (see M72_GetStat: M72_BLK_IRQ_PROFILE)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: return   time
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 ProfTime(
+   LL_HANDLE    *llHdl	/* nodoc */
+)
+{
+	u_int32 ch = llHdl->tbChan;
+
+	/* force latch, restore config */
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch),
+			   (u_int16)((llHdl->regCountCtrl[ch] & ~STORE_MASK) |
+						 (M72_STORE_NOW << 4)));
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(ch), llHdl->regCountCtrl[ch]);
+
+	return( MREAD_D16(llHdl->ma, COUNT_LOW_REG(ch)) |
+			((u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(ch)) << 16) );
+}
+
+/********************************* ProfBin **********************************
+ *
+ *  Description: Get ISR profile histogram bin of value
+ *
+ *               Bin 0 = 0, bin n = 2^(n-1)..2^n-1, values >= 2^31 are
+ *               counted in the last bin.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: val	  value
+ *  Output.....: return   bin
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 ProfBin(
+   u_int32      val	/* nodoc */
+)
+{
+	u_int32 bin = 0;
+
+	while (val && bin < PROF_BINS - 1) {
+		val >>= 1;
+		bin++;
+	}
+
+	return(bin);
+}
+
+/********************************* ProfGet **********************************
+ *
+ *  Description: Copy ISR profile
+ *
+ *               (see M72_GetStat: M72_BLK_IRQ_PROFILE)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: prof     ISR profile
+ *  Globals....: -
+ ****************************************************************************/
+static void ProfGet(
+   LL_HANDLE        *llHdl,
+   M72_ISR_PROFILE  *prof	/* nodoc */
+)
+{
+	IRQ_PROF *p = &llHdl->prof;
+	OSS_IRQ_STATE oldState;
+	u_int32 n;
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	prof->rate     = TIMEBASE_RATE;
+	prof->count    = p->count;
+	prof->durLast  = p->durLast;
+	prof->durMax   = p->durMax;
+	prof->latRate  = TIMEBASE_RATE;
+	prof->latCount = p->latCount;
+	prof->latLast  = p->latLast;
+	prof->latMax   = p->latMax;
+
+	for (n=0; n<PROF_BINS; n++) {
+		prof->durHist[n] = p->durHist[n];
+		prof->latHist[n] = p->latHist[n];
+	}
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+}
+#endif
+
+/********************************* IrqEnbMask *******************************
+ *
+ *  Description: Update the mask of pending bits of the enabled channels
+ *
+ *               Must be called whenever enbIrq[] is changed. The interrupt
+ *               service routine only evaluates the pending bits of the
+ *               enabled channels and only reads the Interrupt Status
+ *               Registers of enabled channel pairs.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void IrqEnbMask(
+   LL_HANDLE    *llHdl	/* nodoc */
+)
+{
+	u_int32 n, mask = 0;
+
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n])
+			mask |= CHAN_PEND_MASK << (n<<3);
+	}
+
+	llHdl->irqEnbMask = mask;
+}
+
+/********************************* IrqActMask *******************************
+ *
+ *  Description: Update the masks of pending bits with a consumer
+ *
+ *               Must be called whenever the signals, the read mode, the
+ *               FIFO events, continuous measurement, capture mode, the
+ *               64-bit extension or the cam table of a channel is changed.
+ *               M72_Irq only dispatches the pending bits with a consumer
+ *               (actPend):
+ *               - installed signal (sigPend)
+ *               - handled by the driver (hwPend): Ready with continuous
+ *                 measurement, Comparator with cam table/interval
+ *                 sequence, Carry/Borrow with 64-bit extension, Line-Break
+ *               - stored in the FIFO (fifoPend) or in the event ring/event
+ *                 queue (evPend)
+ *               - releasing a read (wakePend): Ready with waiting read,
+ *                 stored in the FIFO with queued read
+ *               All but the driver's own handling are OS-level work
+ *               (osPend): only these need a timestamp and deferred work.
+ *               A consumer removed by M72_Irq (end of interval sequence)
+ *               is checked there again.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void IrqActMask(
+   LL_HANDLE    *llHdl	/* nodoc */
+)
+{
+	u_int32 n, events, hw, fifo, ev, wake;
+	u_int32 hwMask = 0, fifoMask = 0, evMask = 0, wakeMask = 0;
+
+	for (n=0; n<CH_NUMBER; n++) {
+		events = llHdl->capture[n] ? M72_INT_XIN2 : llHdl->fifo[n].events;
+
+		hw = M72_INT_LBREAK;
+		if (llHdl->continuous[n])
+			hw |= M72_INT_READY;
+		if (llHdl->cam[n].mode)
+			hw |= M72_INT_COMP;
+		if (llHdl->ext64[n])
+			hw |= M72_INT_CYBW;
+
+		/* queued read/continuous meas.: Ready always stored in FIFO */
+		fifo = 0;
+		if (llHdl->fifo[n].depth) {
+			fifo = events;
+			if (llHdl->readMode[n] == M72_READ_QUEUE || llHdl->continuous[n])
+				fifo |= M72_INT_READY;
+		}
+		ev = (llHdl->evRing || llHdl->evq.depth) ? events : 0;
+
+		wake = 0;
+		if (llHdl->readMode[n] == M72_READ_WAIT)
+			wake = M72_INT_READY;
+		if (llHdl->readMode[n] == M72_READ_QUEUE)
+			wake = fifo;
+
+		hwMask   |= hw   << (n<<3);
+		fifoMask |= fifo << (n<<3);
+		evMask   |= ev   << (n<<3);
+		wakeMask |= wake << (n<<3);
+	}
+
+	llHdl->hwPend   = hwMask;
+	llHdl->fifoPend = fifoMask;
+	llHdl->evPend   = evMask;
+	llHdl->wakePend = wakeMask;
+	llHdl->osPend   = fifoMask | evMask | wakeMask | llHdl->sigPend;
+	llHdl->actPend  = hwMask | llHdl->osPend;
+}
+
+/******************************** PretrigEnable *****************************
+ *
+ *  Description: Enable/disable pretrigger mode
+ *
+ *               (see M72_SetStat: M72_EN_PRETRIG)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               enable   enable (1) or disable (0)
+ *  Output.....: return   success (0) or error code
+ *  Globals....: -
+ ****************************************************************************/
+static int32 PretrigEnable(
+   LL_HANDLE    *llHdl,
+   int32        enable	/* nodoc */
+)
+{
+	u_int32 p = llHdl->ptPeriod, n, t;
+	OSS_IRQ_STATE oldState;
+
+	if (!IN_RANGE(enable,0,1))
+		return(ERR_LL_ILL_PARAM);
+
+	/*--------------------+
+	 |  disable           |
+	 +--------------------*/
+	if (!enable) {
+		DBGWRT_1((DBH, " pretrigger OFF\n"));
+
+		/* disabled twice: stop now, else synchronous at next xIN2 edge */
+		if (!llHdl->enPretrig && llHdl->ptActive) {
+			oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+			PretrigStop(llHdl);
+			OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+		}
+
+		llHdl->enPretrig = FALSE;	/* passed ASYNCHRONOUS to IRQ! */
+		return(ERR_SUCCESS);
+	}
+
+	/*--------------------+
+	 |  enable            |
+	 +--------------------*/
+	/* timers must be different and not the timebase */
+	if (llHdl->ptPeriod == llHdl->ptSet ||
+		llHdl->ptPeriod == llHdl->ptClr ||
+		llHdl->ptSet    == llHdl->ptClr ||
+		llHdl->tbChan   == llHdl->ptPeriod ||
+		llHdl->tbChan   == llHdl->ptSet ||
+		llHdl->tbChan   == llHdl->ptClr)
+		return(ERR_LL_ILL_PARAM);
+
+	DBGWRT_1((DBH, " pretrigger ON\n"));
+
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+
+	/* stop cam table/sequence and capture on the pretrigger channels */
+	for (n=0; n<3; n++) {
+		t = n==0 ? llHdl->ptPeriod : (n==1 ? llHdl->ptSet : llHdl->ptClr);
+		llHdl->cam[t].mode  = M72_CAM_OFF;
+		llHdl->capture[t]   = FALSE;
+	}
+	IrqActMask(llHdl);
+
+	PretrigPredReset(llHdl, 0);
+	llHdl->ptLoadSet = 0;
+	llHdl->ptLoadClr = 0;
+	llHdl->ptLatch   = 0;
+	PretrigSetup(llHdl);
+
+	/* irq enabling for the whole period timer channel */
+	llHdl->enbIrq[p]  = TRUE;
+	IrqEnbMask(llHdl);
+	llHdl->xin2Irq[p] = 1;
+	llHdl->regIrqCtrl[p] |= (u_int16)(ENB_MASK | XIN2_ENB);
+	MWRITE_D16(llHdl->ma,IRQ_CTRL_REG(p),llHdl->regIrqCtrl[p]);
+
+	llHdl->enPretrig = TRUE;
+	llHdl->ptActive  = TRUE;
+
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	return(ERR_SUCCESS);
+}
+
+/******************************** PretrigStop *******************************
+ *
+ *  Description: Stop pretrigger engine
+ *
+ *               Disables the xIN2 Edge interrupt of the period timer and
+ *               reloads the edge timers with maximal dummy values, i.e. no
+ *               further edges are generated.
+ *               Must be called with interrupts masked or from M72_Irq.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PretrigStop(
+   LL_HANDLE    *llHdl	/* nodoc */
+)
+{
+	u_int32 p = llHdl->ptPeriod;
+
+	/* disable IRQ of xIN2 */
+	llHdl->xin2Irq[p] = 0;
+	llHdl->regIrqCtrl[p] &= ~XIN2_ENB;
+	MWRITE_D16(llHdl->ma,IRQ_CTRL_REG(p),llHdl->regIrqCtrl[p]);
+
+	/* edge timers: max. dummy preload */
+	MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(llHdl->ptSet), 0xffff);
+	MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(llHdl->ptSet), 0x7fff);
+	MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(llHdl->ptClr), 0xffff);
+	MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(llHdl->ptClr), 0x7fff);
+
+	llHdl->ptActive = FALSE;
+}
+
+/******************************** PretrigIrq ********************************
+ *
+ *  Description: Pretrigger part of the interrupt service routine
+ *
+ *               Called from M72_Irq in pretrigger mode. At the xIN2 Edge
+ *               interrupt of the period timer, the period latch is read,
+ *               the next period is predicted and the edge timer preloads
+ *               are written. If the pretrigger was disabled meanwhile, the
+ *               engine is stopped (synchronous output shutdown).
+ *
+ *               The period latch is overwritten by the latency measurement
+ *               (see PretrigLatComp), so the value read here is kept for
+ *               the events of the period timer and M72_Read.
+ *
+ *               (see M72_SetStat: M72_EN_PRETRIG)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               irqState pending irq flags (IRQ_STATE_REG2/1)
+ *  Output.....: return   period latch read (TRUE/FALSE)
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 PretrigIrq(
+   LL_HANDLE    *llHdl,
+   u_int32      irqState	/* nodoc */
+)
+{
+	u_int32 p = llHdl->ptPeriod;
+	u_int32 cntVal, pred, preloadSet, preloadClr;
+
+	/* xIN2 edge of period timer ? */
+	if (!(irqState & XIN2_PEND(p)))
+		return(FALSE);
+
+	/* user disabled pretriggering since last Irq */
+	if (!llHdl->enPretrig) {
+		PretrigStop(llHdl);
+		return(FALSE);
+	}
+
+	cntVal  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(p));
+	cntVal |= (u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(p)) << 16;
+	llHdl->ptLatch = cntVal;
+
+	/*
+	 *  Calculate preload Values from the predicted period:
+	 *  preload set timer   = period * fracSet - Pretrig
+	 *  preload clear timer = period * fracClr - Pretrig
+	 */
+	pred = PretrigPredict(llHdl, cntVal);
+
+	preloadSet = PretrigFrac(pred, llHdl->ptFracSet) - llHdl->cntPretrig;
+	preloadClr = PretrigFrac(pred, llHdl->ptFracClr) - llHdl->cntPretrig;
+
+	/* period statistics, late preloads */
+	PretrigStatPut(llHdl, cntVal);
+
+	if ((int32)preloadSet < (int32)llHdl->cntPretrig ||
+		(int32)preloadClr < (int32)llHdl->cntPretrig)
+		llHdl->ptStat.late++;
+
+	IDBGWRT_2((DBH, " pretrig: %d cv %08x\n", llHdl->cntPretrig, cntVal));
+
+	/* update both edge timers simultaneous */
+	MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(llHdl->ptSet),
+			   (u_int16)(preloadSet & 0xffff));
+	MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(llHdl->ptSet),
+			   (u_int16)(preloadSet >> 16));
+
+	MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(llHdl->ptClr),
+			   (u_int16)(preloadClr & 0xffff));
+	MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(llHdl->ptClr),
+			   (u_int16)(preloadClr >> 16));
+
+	/* preload latency, compensation of running edge timers */
+	PretrigLatComp(llHdl, preloadSet, preloadClr);
+
+	return(TRUE);
+}
+
+/******************************** PretrigSetup ******************************
+ *
+ *  Description: Setup period and edge timers for pretrigger generation
+ *
+ *               (see M72_SetStat: M72_EN_PRETRIG)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PretrigSetup( LL_HANDLE *llHdl)
+{
+	u_int32 p = llHdl->ptPeriod, t, n;
+	u_int32 outCfg;
+
+	/*--------------------+
+	 |  period timer      |
+	 +--------------------*/
+
+	/* Preload with 0 */
+	llHdl->valPreload[p] = 0;
+	MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(p), 	0);
+	MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(p), 	0);
+
+	/* set COMP_A Value to 0xffffffff */
+	llHdl->valCompA[p] = 0xffffffff;
+	MWRITE_D16(llHdl->ma, COMPA_HIGH_REG(p), 	0xffff);
+	MWRITE_D16(llHdl->ma, COMPA_LOW_REG(p),  	0xffff);
+
+	/* Set OUT_0=1 to let the period timer continously count upwards */
+	MWRITE_D16(llHdl->ma, OUT_CONFIG_REG, (u_int16)0x1);
+
+	/*
+	 *  Direct combined bit setting of CCR:
+	 *   - latch Value on xIN2+
+	 *   - clear on xIN2+ rising edge
+ 	 *   - counter mode: Timer Mode
+	 *  Property
+     *                  Timer Mode      Sta Tim Latch   No Pre- clear
+     * |               |               |rt |bas|on xIN2|load   |on xIN2|
+     * ----------------------------------------------------------------|
+     * | - | - | - | - | 1 | 0 | 1 | 0 | 1 | 0 | 1 | 0 | 0 | 0 | 0 | 1 |
+     * |       0       |       A       |       A       |       1       |
+	 */
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(p), PRETR_CTRL_PERIOD);
+	llHdl->regCountCtrl[p] = PRETR_CTRL_PERIOD;
+	llHdl->cntMode[p]      = M72_MODE_TIMER;
+
+	/*--------------------+
+	 |  edge timers       |
+	 +--------------------*/
+	for (n=0; n<2; n++) {
+		t = n ? llHdl->ptClr : llHdl->ptSet;
+
+		/*
+		 * Set Comp_A = 0 because the timer decrements when xIN1
+		 * is low ( no Vcc is attached to it on DSUB connector)
+		 */
+		llHdl->valCompA[t] = 0x0;
+		MWRITE_D16(llHdl->ma, COMPA_LOW_REG(t),		0 );
+		MWRITE_D16(llHdl->ma, COMPA_HIGH_REG(t), 	0 );
+
+		/* enable Comparator IRQ (only internally, not causing IRq on MM IF) */
+		llHdl->enbIrq[t]     = FALSE;
+		llHdl->regIntStatChan[t] = 0;
+		IrqEnbMask(llHdl);
+		llHdl->compIrq[t]    = M72_COMP_EQUAL;
+		llHdl->regIrqCtrl[t] = M72_COMP_EQUAL << 4;
+		MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(t), llHdl->regIrqCtrl[t]);
+
+		/* counter operating mode: Timer preload on xIN2+, Start at xIN2 edge
+	     *                  Timer Mode      Sta Tim No      Preload No
+	     * |               |               |rt |bas|latch  |on xIN2|clear  |
+	     * ----------------------------------------------------------------|
+	     * | - | - | - | - | 1 | 0 | 1 | 0 | 0 | 0 | 0 | 0 | 0 | 1 | 0 | 0 |
+	     * |       0       |       A       |       0       |       4       |
+		 */
+		MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(t), PRETR_CTRL_EDGE);
+		llHdl->regCountCtrl[t] = PRETR_CTRL_EDGE;
+		llHdl->cntMode[t]      = M72_MODE_TIMER;
+	}
+
+	/*--------------------+
+	 | Compose pretrig Sig|
+	 +--------------------*/
+
+	/*
+	 * generate the output signal by superposition of the edge timers:
+	 * set output if set timer = 0, clear if clear timer = 0
+	 * (default OUT4, Timer B/C: 00 10 01 00 = 0x24nn nnnn, see User manual)
+	 */
+	outCfg = M72_OUTCFG(llHdl->ptOut, llHdl->ptSet, M72_OUT_MODE_HIGH) |
+			 M72_OUTCFG(llHdl->ptOut, llHdl->ptClr, M72_OUT_MODE_LOW);
+
+	llHdl->regOutCtrl1 = (u_int16)(outCfg & 0xffff);
+	llHdl->regOutCtrl2 = (u_int16)(outCfg >> 16);
+	MWRITE_D16(llHdl->ma, OUT_CTRL1_REG, llHdl->regOutCtrl1);
+	MWRITE_D16(llHdl->ma, OUT_CTRL2_REG, llHdl->regOutCtrl2);
+
+	DBGWRT_2((DBH," pretrigger: period=%d set=%d/0x%x clr=%d/0x%x out=%d\n",
+			  p, llHdl->ptSet, llHdl->ptFracSet, llHdl->ptClr,
+			  llHdl->ptFracClr, llHdl->ptOut));
+}
+
+/******************************** PretrigFrac *******************************
+ *
+ *  Description: Fraction of a period
+ *
+ *               Returns cnt * frac / 0x10000 without 64-bit arithmetic
+ *               (called from M72_Irq).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: cnt      period [ticks]
+ *               frac     fraction (0..M72_PRETRIG_FRAC_ONE)
+ *  Output.....: return   fraction of period [ticks]
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 PretrigFrac(
+   u_int32      cnt,
+   u_int32      frac	/* nodoc */
+)
+{
+	return( (cnt >> 16) * frac + (((cnt & 0xffff) * frac) >> 16) );
+}
+
+/******************************** PretrigStatPut ****************************
+ *
+ *  Description: Add period to pretrigger statistics
+ *
+ *               Called from M72_Irq. The sums are kept as 64-bit values
+ *               (two 32-bit words) to avoid 64-bit arithmetic.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               cnt      period [ticks]
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PretrigStatPut(
+   LL_HANDLE    *llHdl,
+   u_int32      cnt		/* nodoc */
+)
+{
+	PRETRIG_STAT *st = &llHdl->ptStat;
+	u_int32 dev, sq, old, bin;
+	int32 d;
+
+	/* first period: reference for deviations */
+	if (st->count++ == 0)
+		st->ref = cnt;
+
+	if (cnt < st->min)
+		st->min = cnt;
+	if (cnt > st->max)
+		st->max = cnt;
+
+	/* sum of deviations (signed) */
+	d   = (int32)(cnt - st->ref);
+	old = st->sumLow;
+	st->sumLow  += (u_int32)d;
+	st->sumHigh += (d < 0 ? 0xffffffff : 0) + (st->sumLow < old);
+
+	/* sum of squared deviations */
+	dev = (u_int32)(d < 0 ? -d : d);
+	if (dev > PRETR_DEV_MAX)
+		dev = PRETR_DEV_MAX;
+	sq  = dev * dev;
+	old = st->sqLow;
+	st->sqLow  += sq;
+	st->sqHigh += (st->sqLow < old);
+
+	/* histogram */
+	if (cnt < st->histBase) {
+		st->histUnder++;
+	}
+	else {
+		bin = (cnt - st->histBase) >> st->histShift;
+		if (bin < M72_PRETRIG_HIST_BINS)
+			st->hist[bin]++;
+		else
+			st->histOver++;
+	}
+}
+
+/******************************** PretrigStatClear **************************
+ *
+ *  Description: Clear pretrigger statistics (histogram config is kept)
+ *
+ *               Must be called with interrupts masked or from M72_Init.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PretrigStatClear(
+   LL_HANDLE    *llHdl	/* nodoc */
+)
+{
+	PRETRIG_STAT *st = &llHdl->ptStat;
+	u_int32 n;
+
+	st->count     = 0;
+	st->min       = 0xffffffff;
+	st->max       = 0;
+	st->ref       = 0;
+	st->sumLow    = 0;
+	st->sumHigh   = 0;
+	st->sqLow     = 0;
+	st->sqHigh    = 0;
+	st->late      = 0;
+	st->histUnder = 0;
+	st->histOver  = 0;
+	st->outliers  = 0;
+	st->errLow    = 0;
+	st->errHigh   = 0;
+	st->errMax    = 0;
+	st->latency   = 0;
+	st->latMax    = 0;
+	st->latLow    = 0;
+	st->latHigh   = 0;
+	st->compensated = 0;
+	st->missed    = 0;
+
+	for (n=0; n<M72_PRETRIG_HIST_BINS; n++)
+		st->hist[n] = 0;
+}
+
+/******************************** PretrigStatGet ****************************
+ *
+ *  Description: Get pretrigger statistics
+ *
+ *               (see M72_GetStat: M72_BLK_PRETRIG_STAT)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *  Output.....: stat     statistics
+ *  Globals....: -
+ ****************************************************************************/
+static void PretrigStatGet(
+   LL_HANDLE        *llHdl,
+   M72_PRETRIG_STAT *stat	/* nodoc */
+)
+{
+	OSS_IRQ_STATE oldState;
+	PRETRIG_STAT st;
+	u_int32 n, neg, mdev, sq;
+
+	/* consistent copy */
+	oldState = OSS_IrqMaskR(llHdl->osHdl, llHdl->irqHdl);
+	st = llHdl->ptStat;
+	OSS_IrqRestore(llHdl->osHdl, llHdl->irqHdl, oldState);
+
+	stat->count     = st.count;
+	stat->min       = st.count ? st.min : 0;
+	stat->max       = st.max;
+	stat->late      = st.late;
+	stat->histBase  = st.histBase;
+	stat->histShift = st.histShift;
+	stat->histUnder = st.histUnder;
+	stat->histOver  = st.histOver;
+	stat->outliers  = st.outliers;
+	stat->errMax    = st.errMax;
+	stat->errMean   = st.count ? Div64(st.errHigh, st.errLow, st.count) : 0;
+	stat->latency   = st.latency;
+	stat->latMax    = st.latMax;
+	stat->latMean   = st.count ? Div64(st.latHigh, st.latLow, st.count) : 0;
+	stat->compensated = st.compensated;
+	stat->missed    = st.missed;
+
+	for (n=0; n<M72_PRETRIG_HIST_BINS; n++)
+		stat->hist[n] = st.hist[n];
+
+	if (st.count == 0) {
+		stat->mean     = 0;
+		stat->variance = 0;
+		return;
+	}
+
+	/* mean deviation = sum / count (sum is signed) */
+	neg = st.sumHigh & 0x80000000;
+	if (neg) {
+		st.sumLow  = ~st.sumLow + 1;
+		st.sumHigh = ~st.sumHigh + (st.sumLow == 0);
+	}
+	mdev = Div64(st.sumHigh, st.sumLow, st.count);
+	stat->mean = neg ? st.ref - mdev : st.ref + mdev;
+
+	/* variance = mean of squares - square of mean */
+	if (mdev > PRETR_DEV_MAX)
+		mdev = PRETR_DEV_MAX;
+	sq = Div64(st.sqHigh, st.sqLow, st.count);
+	stat->variance = (sq > mdev * mdev) ? sq - mdev * mdev : 0;
+}
+
+/******************************** Div64 *************************************
+ *
+ *  Description: Divide 64-bit value by 32-bit value
+ *
+ *               Shift/subtract division, since 64-bit division is not
+ *               available in all environments. The quotient is limited
+ *               to 0xffffffff.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: high     dividend bits 32..63
+ *               low      dividend bits 0..31
+ *               div      divisor (>0)
+ *  Output.....: return   quotient
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 Div64(
+   u_int32      high,
+   u_int32      low,
+   u_int32      div		/* nodoc */
+)
+{
+	u_int32 rem = 0, quot = 0, carry;
+	int32 n;
+
+	/* quotient exceeds 32 bits ? */
+	if (high >= div)
+		return(0xffffffff);
+
+	rem = high;
+
+	for (n=31; n>=0; n--) {
+		carry = rem & 0x80000000;
+		rem   = (rem << 1) | ((low >> n) & 1);
+		quot <<= 1;
+
+		if (carry || rem >= div) {
+			rem -= div;
+			quot |= 1;
+		}
+	}
+
+	return(quot);
+}
+
+/******************************** PretrigPredict ****************************
+ *
+ *  Description: Predict next period from measured period
+ *
+ *               Called from M72_Irq. Integer arithmetic only, the window
+ *               and gain are powers of two (see M72_SetStat:
+ *               M72_PRETRIG_PRED). Updates the prediction error and
+ *               outlier statistics.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               cnt      measured period [ticks]
+ *  Output.....: return   predicted next period [ticks]
+ *  Globals....: -
+ ****************************************************************************/
+static u_int32 PretrigPredict(
+   LL_HANDLE    *llHdl,
+   u_int32      cnt		/* nodoc */
+)
+{
+	PRETRIG_PRED *pr = &llHdl->ptPred;
+	PRETRIG_STAT *st = &llHdl->ptStat;
+	u_int32 k = llHdl->ptPredK;
+	u_int32 err, old, level;
+	int32 d;
+
+	/* first period: nothing to predict from */
+	if (pr->valid == 0) {
+		PretrigPredReset(llHdl, cnt);
+		return(cnt);
+	}
+
+	/* prediction error */
+	err = cnt > pr->pred ? cnt - pr->pred : pr->pred - cnt;
+	old = st->errLow;
+	st->errLow  += err;
+	st->errHigh += (st->errLow < old);
+	if (err > st->errMax)
+		st->errMax = err;
+
+	/* outlier ? */
+	if (llHdl->ptBand && err > PretrigFrac(pr->pred, llHdl->ptBand)) {
+		st->outliers++;
+
+		/* persistent: period changed, restart */
+		if (++pr->outl >= (1UL << k))
+			PretrigPredReset(llHdl, cnt);
+
+		return(pr->pred);
+	}
+
+	pr->outl = 0;
+	pr->valid++;
+
+	switch (llHdl->ptPredMode) {
+		case M72_PRED_AVG:
+			/* window sum: replace oldest period */
+			old = pr->sumLow;
+			pr->sumLow  += cnt;
+			pr->sumHigh += (pr->sumLow < old);
+			old = pr->sumLow;
+			pr->sumLow  -= pr->win[pr->idx];
+			pr->sumHigh -= (pr->sumLow > old);
+			pr->win[pr->idx] = cnt;
+			pr->idx = (pr->idx + 1) & ((1UL << k) - 1);
+
+			pr->pred = k ? (pr->sumLow >> k) | (pr->sumHigh << (32 - k)) :
+						   pr->sumLow;
+			break;
+
+		case M72_PRED_EXP:
+			/* level += (cnt - level) / 2^k */
+			d = (int32)(cnt - pr->level);
+			pr->level += d < 0 ? -(int32)((u_int32)-d >> k) :
+								 (int32)((u_int32)d >> k);
+			pr->pred = pr->level;
+			break;
+
+		case M72_PRED_TREND:
+			/*
+			 * level = level+trend + (cnt - (level+trend)) / 2^k
+			 * The remainder of the division is carried to the next
+			 * period, else the level stays up to 2^k ticks behind a
+			 * ramp.
+			 */
+			level = pr->level + PretrigRsh(pr->trend, PRETR_TREND_FRAC);
+			d = (int32)(cnt - level) + pr->rem;
+			pr->rem = d & ((1L << k) - 1);
+			level += (d - pr->rem) / (1L << k);
+
+			/*
+			 * trend += (level - level_old - trend) / 2^k
+			 * The trend keeps fraction bits, else slopes below 2^k
+			 * ticks per period would never be picked up.
+			 */
+			d = (int32)(level - pr->level);
+			if (d > PRETR_TREND_MAX)
+				d = PRETR_TREND_MAX;
+			if (d < -PRETR_TREND_MAX)
+				d = -PRETR_TREND_MAX;
+			pr->trend += PretrigRsh(d * (1L << PRETR_TREND_FRAC) - pr->trend, k);
+			pr->level = level;
+			pr->pred  = level + PretrigRsh(pr->trend, PRETR_TREND_FRAC);
+			break;
+
+		default: /* M72_PRED_LAST */
+			pr->pred = cnt;
+	}
+
+	return(pr->pred);
+}
+
+/******************************** PretrigPredReset **************************
+ *
+ *  Description: Restart predictor with period
+ *
+ *               cnt=0 marks the predictor as empty, the next measured
+ *               period restarts it.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               cnt      period [ticks]
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PretrigPredReset(
+   LL_HANDLE    *llHdl,
+   u_int32      cnt		/* nodoc */
+)
+{
+	PRETRIG_PRED *pr = &llHdl->ptPred;
+	u_int32 k = llHdl->ptPredK, n;
+
+	pr->valid   = cnt ? 1 : 0;
+	pr->pred    = cnt;
+	pr->level   = cnt;
+	pr->trend   = 0;
+	pr->rem     = 0;
+	pr->idx     = 0;
+	pr->outl    = 0;
+
+	/* window filled with period */
+	for (n=0; n<(1UL << k); n++)
+		pr->win[n] = cnt;
+
+	pr->sumLow  = k ? cnt << k : cnt;
+	pr->sumHigh = k ? cnt >> (32 - k) : 0;
+}
+
+/******************************** PretrigRsh ********************************
+ *
+ *  Description: Divide by 2^k, rounded (symmetric to zero)
+ *
+ *               Called from M72_Irq (M72_PRED_TREND).
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: d        dividend
+ *               k        shift (0..31)
+ *  Output.....: return   d / 2^k
+ *  Globals....: -
+ ****************************************************************************/
+static int32 PretrigRsh(
+   int32        d,
+   u_int32      k		/* nodoc */
+)
+{
+	u_int32 half = k ? 1UL << (k - 1) : 0;
+
+	return( d < 0 ? -(int32)(((u_int32)-d + half) >> k) :
+					 (int32)(((u_int32)d + half) >> k) );
+}
+
+/******************************** PretrigLatComp ****************************
+ *
+ *  Description: Measure preload latency, compensate running edge timers
+ *
+ *               Called from M72_Irq after the preloads for the next xIN2
+ *               edge were written. Latches the period timer (ticks since
+ *               the xIN2 edge, overwrites the period latch, see
+ *               PretrigIrq). If M72_PRETRIG_LATCOMP is enabled, the
+ *               running edge timers are reloaded with the preloads minus
+ *               the elapsed ticks, then the preloads are restored.
+ *
+ *               (see M72_SetStat: M72_PRETRIG_LATCOMP)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl	  low-level handle
+ *               set      set edge preload
+ *               clr      clr edge preload
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void PretrigLatComp(
+   LL_HANDLE    *llHdl,
+   u_int32      set,
+   u_int32      clr		/* nodoc */
+)
+{
+	PRETRIG_STAT *st = &llHdl->ptStat;
+	u_int32 p = llHdl->ptPeriod;
+	u_int32 elapsed, old, load, run, t, n;
+
+	/* latch period timer now */
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(p),
+			   (u_int16)((PRETR_CTRL_PERIOD & ~STORE_MASK) |
+						 (M72_STORE_NOW << 4)));
+	MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(p), PRETR_CTRL_PERIOD);
+	llHdl->regCountCtrl[p] = PRETR_CTRL_PERIOD;
+	llHdl->cntMode[p]      = M72_MODE_TIMER;
+
+	elapsed = MREAD_D16(llHdl->ma, COUNT_LOW_REG(p)) |
+			  ((u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(p)) << 16);
+
+	st->latency = elapsed;
+	if (elapsed > st->latMax)
+		st->latMax = elapsed;
+	old = st->latLow;
+	st->latLow  += elapsed;
+	st->latHigh += (st->latLow < old);
+
+	for (n=0; n<2; n++) {
+		t    = n ? llHdl->ptClr : llHdl->ptSet;
+		load = n ? clr : set;
+		run  = n ? llHdl->ptLoadClr : llHdl->ptLoadSet;
+
+		if (n)
+			llHdl->ptLoadClr = load;
+		else
+			llHdl->ptLoadSet = load;
+
+		/* first period: edge timers not running */
+		if (!llHdl->ptLatComp || run == 0)
+			continue;
+
+		/* edge already reached (running or new preload) ? */
+		if ((int32)load <= (int32)elapsed || (int32)run <= (int32)elapsed) {
+			st->missed++;
+			continue;
+		}
+
+		/* load remaining ticks now, then restore preload */
+		MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(t),
+				   (u_int16)((load - elapsed) & 0xffff));
+		MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(t),
+				   (u_int16)((load - elapsed) >> 16));
+
+		MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(t),
+				   (u_int16)((PRETR_CTRL_EDGE & ~PRELOAD_MASK) |
+							 (M72_PRELOAD_NOW << 2)));
+		MWRITE_D16(llHdl->ma, COUNT_CTRL_REG(t), PRETR_CTRL_EDGE);
+
+		MWRITE_D16(llHdl->ma, PRELOAD_LOW_REG(t), (u_int16)(load & 0xffff));
+		MWRITE_D16(llHdl->ma, PRELOAD_HIGH_REG(t), (u_int16)(load >> 16));
+
+		st->compensated++;
+	}
+}
+
 void M72_OsDelay( void *oss, u_int32 msec )
 {
 	OSS_Delay(oss, msec);
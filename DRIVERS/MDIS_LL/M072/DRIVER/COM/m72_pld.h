@@ -48,6 +48,8 @@
 
 #define __M72_PldData			M72_GLOBNAME(M72_VARIANT,PldData)
 #define __M72_PldIdent			M72_GLOBNAME(M72_VARIANT,PldIdent)
+#define __M72_PldData01			M72_GLOBNAME(M72_VARIANT,PldData01)
+#define __M72_PldIdent01		M72_GLOBNAME(M72_VARIANT,PldIdent01)
 
 
 
@@ -55,11 +57,13 @@
 |   EXTERNALS                           |
 +--------------------------------------*/
 extern const u_int8 __M72_PldData[];
+extern const u_int8 __M72_PldData01[];
 
 /*--------------------------------------+
 |   PROTOTYPES                          |
 +--------------------------------------*/
 char* __M72_PldIdent(void);
+char* __M72_PldIdent01(void);
 
 
 #ifdef __cplusplus
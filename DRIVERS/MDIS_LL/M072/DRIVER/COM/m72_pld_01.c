@@ -4,9 +4,9 @@
  *
  *      \author  ts
  *
- *      \brief   PLD data array for M72 Pretrigger driver Variant -01 which
- *               has Trigger Signals OUT_4 and AIN2+ also routed to MM IF
- *               pins TRIG_A and TRIG_B
+ *      \brief   PLD data array for M72 Variant -01 which has Trigger
+ *               Signals OUT_4 and AIN2+ also routed to MM IF pins TRIG_A
+ *               and TRIG_B (selected by descriptor key PLD_VARIANT=1)
  *
  *     \switches 
  */
@@ -34,8 +34,8 @@
 
 static const char IdentString[]=MENT_XSTR(MAK_REVISION);
 
-/* M72_PldIdent: return ident string */
-char* __M72_PldIdent( void )
+/* M72_PldIdent01: return ident string */
+char* __M72_PldIdent01( void )
 {
 	return( (char*) IdentString );
 }
@@ -43,7 +43,7 @@ char* __M72_PldIdent( void )
 /* 
  *
  */
-const u_int8 __M72_PldData[] = {
+const u_int8 __M72_PldData01[] = {
 /* size */
 0x00,0x01,0x2f,0x57,
 /* data */
@@ -0,0 +1,261 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                   M72_EVRING                       ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: see
+ *
+ *  Description: M72 example for reading the event ring
+ *
+ *               Configuration:
+ *               - event ring must be enabled in the descriptor
+ *                 (EVRING_SIZE), events are configured per channel
+ *                 (FIFO_EVENTS, ENB_IRQ ...)
+ *
+ *               Measurement:
+ *               - read a copy of the event ring (M72_BLK_EVRING)
+ *               - print new records
+ *               - with -d: attach to the event ring itself and read it
+ *                 without system calls (only if the driver was built
+ *                 with M72_EVRING_SHARED, see m72_drv.h)
+ *
+ *     Required: MDIS user interface library
+ *     Switches: NO_MAIN_FUNC	(for systems with one namespace)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <MEN/men_typs.h>
+#include <MEN/mdis_api.h>
+#include <MEN/mdis_err.h>
+#include <MEN/usr_oss.h>
+#include <MEN/usr_utl.h>
+#include <MEN/m72_drv.h>
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define LOOPDELAY	100		/* loop delay [ms] */
+#define RING_MAX	0x10000	/* max. ring size (records) */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static int32 EvRingRead(M72_EVRING *ring, u_int32 *tailP, M72_EVRING_REC *rec);
+static void PrintError(char *info);
+
+/********************************* main *************************************
+ *
+ *  Description: MAIN entry
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: argc, argv	   command line arguments/counter
+ *  Output.....: return	       success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	MDIS_PATH path=0;
+	INT32_OR_64 addr = 0;
+	M_SG_BLOCK blk;
+	M72_EVRING *ring, *copy = NULL;
+	M72_EVRING_REC rec;
+	u_int32 tail = 0, lost = 0;
+	int32 ret, copyMode = 1;
+	char *device;
+
+	if (argc < 2 || strcmp(argv[1],"-?")==0) {
+		printf("Syntax: m72_evring <device> [-d]\n");
+		printf("Function: M72 example for reading the event ring\n");
+		printf("Options:\n");
+		printf("    device       device name\n");
+		printf("    -d           read the ring directly (no copy)\n");
+		printf("                 (driver and application must share one\n");
+		printf("                 address space, M72_EVRING_SHARED)\n");
+		printf("\n");
+		return(1);
+	}
+
+	device = argv[1];
+	if (argc > 2 && strcmp(argv[2],"-d")==0)
+		copyMode = 0;
+
+	/*--------------------+
+    |  open path          |
+    +--------------------*/
+	if ((path = M_open(device)) < 0) {
+		PrintError("open");
+		return(1);
+	}
+
+	/*--------------------+
+    |  attach to ring     |
+    +--------------------*/
+	if (copyMode) {
+		if ((copy = (M72_EVRING*)malloc(M72_EVRING_SIZE(RING_MAX))) == NULL) {
+			printf("*** can't alloc copy buffer\n");
+			goto abort;
+		}
+		blk.size = M72_EVRING_SIZE(RING_MAX);
+		blk.data = (void*)copy;
+
+		if ((M_getstat(path, M72_BLK_EVRING, (int32*)&blk)) < 0) {
+			PrintError("getstat M72_BLK_EVRING");
+			goto abort;
+		}
+		ring = copy;
+	}
+	else {
+		if ((M_getstat(path, M72_EVRING_ADDR, (int32*)&addr)) < 0) {
+			PrintError("getstat M72_EVRING_ADDR");
+			goto abort;
+		}
+		ring = (M72_EVRING*)addr;
+	}
+
+	if (ring == NULL || ring->magic != M72_EVRING_MAGIC) {
+		printf("*** no event ring (descriptor key EVRING_SIZE)\n");
+		goto abort;
+	}
+
+	/* start with the oldest record still in the ring */
+	tail = ring->head > ring->size ? ring->head - ring->size : 0;
+
+	/*--------------------+
+    |  read loop          |
+    +--------------------*/
+	printf("event ring: %ld records\n", (long)ring->size);
+	printf("(Press any key for exit)\n");
+	printf("\n");
+
+	do {
+		while ((ret = EvRingRead(ring, &tail, &rec)) != 0) {
+			if (ret < 0) {
+				lost++;
+				printf("*** records lost (total %ld)\n", (long)lost);
+				continue;
+			}
+
+			printf("seq=%08lx time=%08lx%08lx ch=%ld %c%c%c%c%c value=0x%08lx\n",
+				   (unsigned long)rec.seq, (unsigned long)rec.timeHigh,
+				   (unsigned long)rec.time, (long)rec.channel,
+				   (rec.cause & M72_INT_READY  ? 'R':'.'),
+				   (rec.cause & M72_INT_COMP   ? 'C':'.'),
+				   (rec.cause & M72_INT_CYBW   ? 'Y':'.'),
+				   (rec.cause & M72_INT_LBREAK ? 'L':'.'),
+				   (rec.cause & M72_INT_XIN2   ? 'X':'.'),
+				   (unsigned long)rec.value);
+		}
+
+		UOS_Delay(LOOPDELAY);
+
+		/* refresh copy */
+		if (copyMode &&
+			(M_getstat(path, M72_BLK_EVRING, (int32*)&blk)) < 0) {
+			PrintError("getstat M72_BLK_EVRING");
+			break;
+		}
+
+	} while(UOS_KeyPressed() == -1);	/* while no key pressed */
+
+	/*--------------------+
+    |  cleanup            |
+    +--------------------*/
+	abort:
+	if (copy)
+		free(copy);
+
+	if (M_close(path) < 0)
+		PrintError("close");
+
+	return(0);
+}
+
+/********************************* EvRingRead ********************************
+ *
+ *  Description: Read next record from the event ring (see m72_drv.h)
+ *
+ *               The ring is only read, any number of readers can attach.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: ring	event ring
+ *               tailP	reader's tail index
+ *  Output.....: tailP	updated tail index
+ *               rec	record
+ *               return	1=record read, 0=ring empty,
+ *                      -1=records lost (tail moved to oldest record)
+ *  Globals....: -
+ ****************************************************************************/
+static int32 EvRingRead(M72_EVRING *ring, u_int32 *tailP, M72_EVRING_REC *rec)
+{
+	u_int32 head, tail = *tailP;
+	M72_EVRING_REC *src;
+
+	head = ring->head;
+	M72_EVRING_BARRIER();
+
+	/* ring empty ? */
+	if (head == tail)
+		return(0);
+
+	/* reader overrun ? */
+	if (head - tail > ring->size) {
+		*tailP = head - ring->size;
+		return(-1);
+	}
+
+	/* copy record, then check it was not overwritten meanwhile */
+	src = &ring->rec[tail & (ring->size - 1)];
+	rec->channel = src->channel;
+	rec->cause   = src->cause;
+	rec->value   = src->value;
+	rec->time    = src->time;
+	rec->timeHigh = src->timeHigh;
+	M72_EVRING_BARRIER();
+	rec->seq     = src->seq;
+
+	/* record overwritten: skip it (lost) */
+	if (rec->seq != tail) {
+		*tailP = tail + 1;
+		return(-1);
+	}
+
+	*tailP = tail + 1;
+	return(1);
+}
+
+/********************************* PrintError ********************************
+ *
+ *  Description: Print MDIS error message
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: info	info string
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+
+static void PrintError(char *info)
+{
+	printf("*** can't %s: %s\n", info, M_errstring(UOS_ErrnoGet()));
+}
+
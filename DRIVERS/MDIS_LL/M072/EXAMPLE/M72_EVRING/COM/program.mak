@@ -1,9 +1,8 @@
 #***************************  M a k e f i l e  *******************************
 #
-#         Author: see/ts
+#         Author: see
 #
-#    Description: Makefile definitions for the M72 driver with pretrigger
-#                 Capability
+#    Description: Makefile definitions for the M72 example program
 #
 #-----------------------------------------------------------------------------
 #   Copyright 1998-2019, MEN Mikro Elektronik GmbH
@@ -21,41 +20,25 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-MAK_NAME=m72_pre
+MAK_NAME=m72_evring
 # the next line is updated during the MDIS installation
 STAMPED_REVISION="13M072-06_03_05-3-g9a820db-dirty_2019-05-10"
 
 DEF_REVISION=MAK_REVISION=$(STAMPED_REVISION)
+MAK_SWITCH=$(SW_PREFIX)$(DEF_REVISION)
 
-MAK_SWITCH=$(SW_PREFIX)MAC_MEM_MAPPED \
-		$(SW_PREFIX)$(DEF_REVISION) \
-		$(SW_PREFIX)M72_VARIANT=M72_PRE
+MAK_LIBS=$(LIB_PREFIX)$(MEN_LIB_DIR)/mdis_api$(LIB_SUFFIX)    \
+         $(LIB_PREFIX)$(MEN_LIB_DIR)/usr_oss$(LIB_SUFFIX)     \
+         $(LIB_PREFIX)$(MEN_LIB_DIR)/usr_utl$(LIB_SUFFIX)     \
 
-MAK_LIBS=$(LIB_PREFIX)$(MEN_LIB_DIR)/desc$(LIB_SUFFIX)     \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/oss$(LIB_SUFFIX)      \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/id$(LIB_SUFFIX)      \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/pld$(LIB_SUFFIX)      \
-         $(LIB_PREFIX)$(MEN_LIB_DIR)/dbg$(LIB_SUFFIX)     \
-
-MAK_INCL=$(MEN_MOD_DIR)/m72_pld.h     \
-		 $(MEN_INC_DIR)/m72_drv.h     \
+MAK_INCL=$(MEN_INC_DIR)/m72_drv.h     \
          $(MEN_INC_DIR)/men_typs.h    \
-         $(MEN_INC_DIR)/oss.h         \
-         $(MEN_INC_DIR)/mdis_err.h    \
-         $(MEN_INC_DIR)/maccess.h     \
-         $(MEN_INC_DIR)/desc.h        \
-         $(MEN_INC_DIR)/pld_load.h    \
          $(MEN_INC_DIR)/mdis_api.h    \
-         $(MEN_INC_DIR)/mdis_com.h    \
-         $(MEN_INC_DIR)/microwire.h   \
-         $(MEN_INC_DIR)/ll_defs.h     \
-         $(MEN_INC_DIR)/ll_entry.h    \
-         $(MEN_INC_DIR)/dbg.h         \
-
-MAK_INP1=m72_drv_pretrig$(INP_SUFFIX)
-MAK_INP2=m72_pld_01$(INP_SUFFIX)
+         $(MEN_INC_DIR)/mdis_err.h    \
+         $(MEN_INC_DIR)/usr_oss.h     \
+         $(MEN_INC_DIR)/usr_utl.h     \
 
-MAK_INP=$(MAK_INP1) \
-        $(MAK_INP2)
+MAK_INP1=m72_evring$(INP_SUFFIX)
 
+MAK_INP=$(MAK_INP1)
  
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/dbg.h> (see TEST/Makefile)
+ *
+ *               Debug output compiled out.
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _DBG_H
+#define _DBG_H
+
+typedef struct { int32 dummy; } DBG_HANDLE;
+
+#define DBGINIT(x)
+#define DBGEXIT(x)
+#define DBGWRT_1(x)
+#define DBGWRT_2(x)
+#define DBGWRT_3(x)
+#define DBGWRT_ERR(x)
+#define IDBGWRT_1(x)
+#define IDBGWRT_2(x)
+#define IDBGWRT_3(x)
+#define IDBGWRT_ERR(x)
+
+#endif /* _DBG_H */
@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/desc.h> (see TEST/Makefile)
+ *
+ *               Descriptor keys are taken from a table set by the test
+ *               (HostDescSet).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _DESC_H
+#define _DESC_H
+
+typedef void DESC_SPEC;
+typedef struct DESC_HANDLE DESC_HANDLE;
+
+int32 DESC_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+				DESC_HANDLE **descHandleP);
+int32 DESC_Exit(DESC_HANDLE **descHandleP);
+int32 DESC_GetUInt32(DESC_HANDLE *descHandle, u_int32 defVal,
+					 u_int32 *valueP, char *keyFmt, ...);
+int32 DESC_DbgLevelSet(DESC_HANDLE *descHandle, u_int32 dbgLevel);
+char *DESC_Ident(void);
+
+#endif /* _DESC_H */
@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/ll_defs.h> (see TEST/Makefile)
+ *
+ *               Low-level driver definitions.
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _LL_DEFS_H
+#define _LL_DEFS_H
+
+#define LL_IRQ_DEV_NOT			0
+#define LL_IRQ_DEVICE			1
+#define LL_IRQ_UNKNOWN			2
+
+#define LL_INFO_HW_CHARACTER	1
+#define LL_INFO_ADDRSPACE_COUNT	2
+#define LL_INFO_ADDRSPACE		3
+#define LL_INFO_IRQ				4
+#define LL_INFO_LOCKMODE		5
+
+#define LL_LOCK_NONE			0
+#define LL_LOCK_CALL			1
+#define LL_LOCK_CHAN			2
+
+#endif /* _LL_DEFS_H */
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/maccess.h> (see TEST/Makefile)
+ *
+ *               The registers are mapped to the simulated register file
+ *               G_hostRegs (m72_host.c), accesses are counted.
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MACCESS_H
+#define _MACCESS_H
+
+typedef volatile u_int8 *MACCESS;
+
+extern u_int16 G_hostRegs[];				/* simulated register file */
+extern u_int32 G_hostRegReads;				/* register reads */
+extern u_int32 G_hostRegWrites;				/* register writes */
+
+#define MREAD_D16(ma,offs) \
+	(G_hostRegReads++, *(volatile u_int16*)((ma)+(offs)))
+#define MWRITE_D16(ma,offs,val) \
+	(G_hostRegWrites++, *(volatile u_int16*)((ma)+(offs)) = (u_int16)(val))
+#define MACCESS_CLONE(ma,ma2,offs)	((ma2)=(ma)+(offs))
+
+#endif /* _MACCESS_H */
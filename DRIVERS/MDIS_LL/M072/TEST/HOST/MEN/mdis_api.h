@@ -0,0 +1,37 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/mdis_api.h> (see TEST/Makefile)
+ *
+ *               Status codes and types used by the driver and examples.
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MDIS_API_H
+#define _MDIS_API_H
+
+#define M_MK_CH_CURRENT		0x0100
+#define M_MK_IRQ_ENABLE		0x0101
+#define M_LL_DEBUG_LEVEL	0x0200
+#define M_LL_IRQ_COUNT		0x0201
+#define M_LL_CH_DIR			0x0202
+#define M_LL_CH_NUMBER		0x0203
+#define M_LL_CH_LEN			0x0204
+#define M_LL_CH_TYP			0x0205
+#define M_LL_ID_CHECK		0x0206
+#define M_LL_ID_SIZE		0x0207
+#define M_MK_BLK_REV_ID		0x4100
+#define M_LL_BLK_ID_DATA	0x4200
+#define M_DEV_OF			0x0800
+#define M_DEV_BLK_OF		0x4800
+
+#define M_CH_INOUT			2
+#define M_CH_COUNTER		3
+
+typedef struct {
+	int32	size;
+	void	*data;
+} M_SG_BLOCK;
+
+#endif /* _MDIS_API_H */
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/mdis_com.h> (see TEST/Makefile)
+ *
+ *               Ident function table.
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MDIS_COM_H
+#define _MDIS_COM_H
+
+#define MDIS_MA08			0x01
+#define MDIS_MD08			0x01
+#define MDIS_MD16			0x02
+#define MAX_MDIS_IDENT_FUNCT 10
+
+typedef struct {
+	struct {
+		char *(*identCall)(void);
+	} idCall[MAX_MDIS_IDENT_FUNCT];
+} MDIS_IDENT_FUNCT_TBL;
+
+#endif /* _MDIS_COM_H */
@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/mdis_err.h> (see TEST/Makefile)
+ *
+ *               Error codes (values differ from MDIS).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MDIS_ERR_H
+#define _MDIS_ERR_H
+
+#define ERR_SUCCESS				0
+#define ERR_OSS_MEM_ALLOC		0x0101
+#define ERR_OSS_TIMEOUT			0x0102
+#define ERR_OSS_SIG_SET			0x0103
+#define ERR_OSS_SIG_CLR			0x0104
+#define ERR_ID					0x0201
+#define ERR_ID_NOTFOUND			0x0202
+#define ERR_PLD					0x0300
+#define ERR_DESC_KEY_NOTFOUND	0x0401
+#define ERR_LL_ILL_PARAM		0x0501
+#define ERR_LL_ILL_DIR			0x0502
+#define ERR_LL_UNK_CODE			0x0503
+#define ERR_LL_USERBUF			0x0504
+#define ERR_LL_READ				0x0505
+#define ERR_LL_WRITE			0x0506
+#define ERR_LL_ILL_ID			0x0507
+#define ERR_LL_ILL_CHAN			0x0508
+#define ERR_LL_DEV_BUSY			0x0509
+#define ERR_LL_ILL_FUNC			0x050a
+#define ERR_LL_DEV_NOTRDY		0x050b
+#define ERR_LL_READ_OVERRUN		0x050c
+
+#endif /* _MDIS_ERR_H */
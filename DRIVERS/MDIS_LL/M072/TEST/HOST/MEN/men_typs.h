@@ -0,0 +1,43 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/men_typs.h> (see TEST/Makefile)
+ *
+ *               Basic types of a 32/64-bit host.
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MEN_TYPS_H
+#define _MEN_TYPS_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int8_t			int8;
+typedef uint8_t			u_int8;
+typedef int16_t			int16;
+typedef uint16_t		u_int16;
+typedef int32_t			int32;
+typedef uint32_t		u_int32;
+typedef int64_t			int64;
+typedef uint64_t		u_int64;
+
+#define INT32_OR_64		long
+#define U_INT32_OR_64	unsigned long
+typedef INT32_OR_64		MDIS_PATH;
+
+#ifndef TRUE
+# define TRUE			1
+#endif
+#ifndef FALSE
+# define FALSE			0
+#endif
+
+#define _MENT_XSTR(x)	#x
+#define MENT_XSTR(x)	_MENT_XSTR(x)
+
+#define IN_RANGE(v,a,b)	((v)>=(a) && (v)<=(b))
+
+#endif /* _MEN_TYPS_H */
@@ -0,0 +1,38 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/microwire.h> (see TEST/Makefile)
+ *
+ *               ID PROM access is not simulated (ID_CHECK=0).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _MICROWIRE_H
+#define _MICROWIRE_H
+
+#define MCRW_DESC_PORT_FLAG_SIZE_16			0x01
+#define MCRW_DESC_PORT_FLAG_READABLE_REG	0x02
+#define MCRW_DESC_PORT_FLAG_POLARITY_HIGH	0x04
+#define MCRW_DESC_PORT_FLAG_OUT_IN_ONE_REG	0x08
+
+typedef struct {
+	u_int32	busClock, addrLength;
+	u_int32	flagsDataIn, flagsDataOut, flagsClockOut, flagsCsOut, flagsOut;
+	void	*addrDataIn, *addrDataOut, *addrClockOut, *addrCsOut;
+	u_int32	maskDataIn, maskDataOut, maskClockOut, maskCsOut;
+	u_int32	notReadBackDefaultsDataOut, notReadBackMaskDataOut;
+	u_int32	notReadBackDefaultsClockOut, notReadBackMaskClockOut;
+	u_int32	notReadBackDefaultsCsOut, notReadBackMaskCsOut;
+} MCRW_DESC_PORT;
+
+typedef struct MCRW_HANDLE {
+	int32 (*ReadEeprom)(void *hdl, u_int32 addr, u_int16 *buf,
+						u_int32 size);
+	int32 (*Exit)(void **hdlP);
+	char *(*Ident)(void);
+} MCRW_HANDLE;
+
+int32 MCRW_PORT_Init(MCRW_DESC_PORT *desc, OSS_HANDLE *osHdl, void **hdlP);
+
+#endif /* _MICROWIRE_H */
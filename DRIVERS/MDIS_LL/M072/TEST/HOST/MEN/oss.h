@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/oss.h> (see TEST/Makefile)
+ *
+ *               Single-threaded host OSS (m72_host.c): interrupt masking is a
+ *               no-op, semaphores never block, alarms are fired by the
+ *               test (HostAlarmFire).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _OSS_H
+#define _OSS_H
+
+typedef struct OSS_HANDLE		OSS_HANDLE;
+typedef struct OSS_IRQ_HANDLE	OSS_IRQ_HANDLE;
+typedef struct OSS_SEM_HANDLE	OSS_SEM_HANDLE;
+typedef struct OSS_SIG_HANDLE	OSS_SIG_HANDLE;
+typedef struct OSS_ALARM_HANDLE	OSS_ALARM_HANDLE;
+typedef int32					OSS_IRQ_STATE;
+
+#define OSS_DBG_DEFAULT		0
+#define OSS_SEM_BIN			0
+#define OSS_SEM_COUNT		1
+
+void *OSS_MemGet(OSS_HANDLE *osHdl, u_int32 size, u_int32 *gotsizeP);
+int32 OSS_MemFree(OSS_HANDLE *osHdl, void *addr, u_int32 size);
+void  OSS_MemFill(OSS_HANDLE *osHdl, u_int32 size, char *adr, int8 value);
+void  OSS_MemCopy(OSS_HANDLE *osHdl, u_int32 size, char *src, char *dst);
+
+int32 OSS_SemCreate(OSS_HANDLE *osHdl, int32 semType, int32 initVal,
+					OSS_SEM_HANDLE **semP);
+int32 OSS_SemRemove(OSS_HANDLE *osHdl, OSS_SEM_HANDLE **semHandleP);
+int32 OSS_SemWait(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle,
+				  int32 msec);
+int32 OSS_SemSignal(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle);
+
+int32 OSS_SigCreate(OSS_HANDLE *osHdl, int32 value,
+					OSS_SIG_HANDLE **sigHandleP);
+int32 OSS_SigRemove(OSS_HANDLE *osHdl, OSS_SIG_HANDLE **sigHandleP);
+int32 OSS_SigSend(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle);
+int32 OSS_SigInfo(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle,
+				  int32 *signalNbrP, int32 *pidP);
+
+OSS_IRQ_STATE OSS_IrqMaskR(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHandle);
+void  OSS_IrqRestore(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHandle,
+					 OSS_IRQ_STATE oldState);
+
+int32 OSS_AlarmCreate(OSS_HANDLE *osHdl, void (*funct)(void *arg),
+					  void *arg, OSS_ALARM_HANDLE **alarmP);
+int32 OSS_AlarmRemove(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE **alarmP);
+int32 OSS_AlarmSet(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm,
+				   u_int32 msec, u_int32 cyclic, u_int32 *realMsecP);
+int32 OSS_AlarmClear(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm);
+
+int32 OSS_Delay(OSS_HANDLE *osHdl, int32 msec);
+int32 OSS_TickGet(OSS_HANDLE *osHdl);
+int32 OSS_TickRateGet(OSS_HANDLE *osHdl);
+char *OSS_Ident(void);
+
+#endif /* _OSS_H */
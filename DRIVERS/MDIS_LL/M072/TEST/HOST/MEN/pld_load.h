@@ -0,0 +1,23 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/pld_load.h> (see TEST/Makefile)
+ *
+ *               The PLD is not loaded (PLD_LOAD=0).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _PLD_LOAD_H
+#define _PLD_LOAD_H
+
+#define PLD_FIRSTBLOCK	0x01
+#define PLD_LASTBLOCK	0x02
+
+int32 PLD_FLEX10K_LoadDirect(MACCESS *ma, u_int8 *buf, u_int32 size,
+							 int32 flags, void *osh,
+							 void (*msecDelay)(void *osh, u_int32 msec),
+							 u_int32 nonPldBits, int dataBit, int dclkBit,
+							 int confBit, int statBit, int cfgdnBit);
+
+#endif /* _PLD_LOAD_H */
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/usr_oss.h> (see TEST/Makefile)
+ *
+ *               User-space calls of the examples (not available on the host,
+ *               the examples are only compiled for their helper functions).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _USR_OSS_H
+#define _USR_OSS_H
+
+MDIS_PATH M_open(char *device);
+int32 M_close(MDIS_PATH path);
+int32 M_getstat(MDIS_PATH path, int32 code, int32 *dataP);
+int32 M_setstat(MDIS_PATH path, int32 code, INT32_OR_64 data);
+char *M_errstring(int32 errCode);
+
+int32 UOS_ErrnoGet(void);
+int32 UOS_Delay(u_int32 msec);
+int32 UOS_KeyPressed(void);
+
+#endif /* _USR_OSS_H */
@@ -0,0 +1,13 @@
+/****************************************************************************
+ *
+ *  Description: Host build stub of <MEN/usr_utl.h> (see TEST/Makefile)
+ *
+ *               (empty)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+
+#ifndef _USR_UTL_H
+#define _USR_UTL_H
+#endif /* _USR_UTL_H */
@@ -0,0 +1,528 @@
+/****************************************************************************
+ *
+ *  Description: Host environment of the M72 driver tests/benchmarks
+ *
+ *               Minimal OSS, DESC, ID and PLD functions and the simulated
+ *               register file for running the driver on the host (see
+ *               m72_host.h). Not thread-safe except for the functions used
+ *               by the event ring test (memory functions).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <MEN/men_typs.h>
+#include <MEN/maccess.h>
+#include <MEN/oss.h>
+#include <MEN/desc.h>
+#include <MEN/microwire.h>
+#include <MEN/pld_load.h>
+#include <MEN/mdis_err.h>
+#include <MEN/usr_oss.h>
+#include "m72_host.h"
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define DESC_KEYS		64			/* max. descriptor keys */
+#define DESC_KEY_LEN	32			/* max. key length */
+
+/*-----------------------------------------+
+|  TYPEDEFS                                |
++-----------------------------------------*/
+struct OSS_SEM_HANDLE {
+	int32			count;
+};
+
+struct OSS_SIG_HANDLE {
+	int32			sigNo;
+};
+
+struct OSS_ALARM_HANDLE {
+	void			(*funct)(void *arg);
+	void			*arg;
+	u_int32			active;
+};
+
+typedef struct {
+	char			key[DESC_KEY_LEN];
+	u_int32			value;
+} DESC_KEY;
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+u_int16 G_hostRegs[HOST_REG_SIZE / 2];
+u_int32 G_hostRegReads;
+u_int32 G_hostRegWrites;
+u_int32 G_hostSemSignals;
+u_int32 G_hostSigSends;
+u_int32 G_hostIrqMasks;
+void (*G_hostMemCopyHook)(void);
+u_int32 G_hostMemCopySplit;
+
+static DESC_KEY G_descKey[DESC_KEYS];
+static u_int32 G_descKeys;
+static OSS_ALARM_HANDLE *G_alarm;
+static u_int32 G_failed;
+static char G_descHdl;
+
+/*-----------------------------------------+
+|  MCRW                                    |
++-----------------------------------------*/
+static char *McrwIdent(void) { return("host MCRW"); }
+static int32 McrwExit(void **hdlP) { *hdlP = NULL; return(0); }
+static int32 McrwRead(void *hdl, u_int32 addr, u_int16 *buf, u_int32 size)
+{
+	(void)hdl; (void)addr; (void)buf; (void)size;
+	return(ERR_ID_NOTFOUND);
+}
+
+static MCRW_HANDLE G_mcrw = { McrwRead, McrwExit, McrwIdent };
+
+/******************************** HostMa ************************************
+ *
+ *  Description: Get access handle of the simulated register file
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return   access handle
+ *  Globals....: G_hostRegs
+ ****************************************************************************/
+MACCESS HostMa(void)
+{
+	return((MACCESS)G_hostRegs);
+}
+
+/******************************** HostRegReset ******************************
+ *
+ *  Description: Clear the simulated register file and access counters
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_hostRegs, G_hostRegReads, G_hostRegWrites
+ ****************************************************************************/
+void HostRegReset(void)
+{
+	memset(G_hostRegs, 0, sizeof(G_hostRegs));
+	G_hostRegReads = G_hostRegWrites = 0;
+}
+
+/******************************** HostDescClear *****************************
+ *
+ *  Description: Remove all descriptor keys
+ *
+ *               PLD_LOAD and ID_CHECK are always 0 on the host.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_descKey
+ ****************************************************************************/
+void HostDescClear(void)
+{
+	G_descKeys = 0;
+	HostDescSet("PLD_LOAD", 0);
+	HostDescSet("ID_CHECK", 0);
+}
+
+/******************************** HostDescSet *******************************
+ *
+ *  Description: Set descriptor key
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: key      key name (e.g. "FIFO_DEPTH_0")
+ *               value    value
+ *  Output.....: -
+ *  Globals....: G_descKey
+ ****************************************************************************/
+void HostDescSet(const char *key, u_int32 value)
+{
+	u_int32 n;
+
+	for (n=0; n<G_descKeys; n++)
+		if (strcmp(G_descKey[n].key, key) == 0)
+			break;
+
+	if (n == DESC_KEYS) {
+		fprintf(stderr, "*** too many descriptor keys\n");
+		exit(1);
+	}
+
+	strncpy(G_descKey[n].key, key, DESC_KEY_LEN - 1);
+	G_descKey[n].value = value;
+	if (n == G_descKeys)
+		G_descKeys++;
+}
+
+/******************************** HostAlarmFire *****************************
+ *
+ *  Description: Execute the alarm routine (one alarm period elapsed)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_alarm
+ ****************************************************************************/
+void HostAlarmFire(void)
+{
+	if (G_alarm && G_alarm->active)
+		G_alarm->funct(G_alarm->arg);
+}
+
+/******************************** HostCycles ********************************
+ *
+ *  Description: Get CPU cycle counter (ns on non-x86 hosts)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return   cycles
+ *  Globals....: -
+ ****************************************************************************/
+u_int64 HostCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return(__builtin_ia32_rdtsc());
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((u_int64)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#endif
+}
+
+/******************************** HostFail **********************************
+ *
+ *  Description: Report failed check (see CHECK)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: file     source file
+ *               line     source line
+ *               cond     failed condition
+ *  Output.....: -
+ *  Globals....: G_failed
+ ****************************************************************************/
+void HostFail(const char *file, int line, const char *cond)
+{
+	printf("*** %s:%d: check failed: %s\n", file, line, cond);
+	G_failed++;
+}
+
+/******************************** HostResult ********************************
+ *
+ *  Description: Print test result
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: name     test name
+ *  Output.....: return   exit code (0=passed)
+ *  Globals....: G_failed
+ ****************************************************************************/
+int HostResult(const char *name)
+{
+	printf("%s: %s (%d failed checks)\n", name,
+		   G_failed ? "FAILED" : "passed", G_failed);
+	return(G_failed ? 1 : 0);
+}
+
+/*-----------------------------------------+
+|  OSS                                     |
++-----------------------------------------*/
+void *OSS_MemGet(OSS_HANDLE *osHdl, u_int32 size, u_int32 *gotsizeP)
+{
+	(void)osHdl;
+	*gotsizeP = size;
+	return(calloc(1, size));
+}
+
+int32 OSS_MemFree(OSS_HANDLE *osHdl, void *addr, u_int32 size)
+{
+	(void)osHdl; (void)size;
+	free(addr);
+	return(0);
+}
+
+void OSS_MemFill(OSS_HANDLE *osHdl, u_int32 size, char *adr, int8 value)
+{
+	(void)osHdl;
+	memset(adr, value, size);
+}
+
+void OSS_MemCopy(OSS_HANDLE *osHdl, u_int32 size, char *src, char *dst)
+{
+	void (*hook)(void) = G_hostMemCopyHook;
+
+	(void)osHdl;
+	/* interrupt copy once (see G_hostMemCopyHook) */
+	if (hook && size > G_hostMemCopySplit) {
+		G_hostMemCopyHook = NULL;
+		memcpy(dst, src, G_hostMemCopySplit);
+		hook();
+		memcpy(dst + G_hostMemCopySplit, src + G_hostMemCopySplit,
+			   size - G_hostMemCopySplit);
+		return;
+	}
+
+	memcpy(dst, src, size);
+}
+
+int32 OSS_SemCreate(OSS_HANDLE *osHdl, int32 semType, int32 initVal,
+					OSS_SEM_HANDLE **semP)
+{
+	(void)osHdl; (void)semType;
+	if ((*semP = calloc(1, sizeof(OSS_SEM_HANDLE))) == NULL)
+		return(ERR_OSS_MEM_ALLOC);
+	(*semP)->count = initVal;
+	return(0);
+}
+
+int32 OSS_SemRemove(OSS_HANDLE *osHdl, OSS_SEM_HANDLE **semHandleP)
+{
+	(void)osHdl;
+	free(*semHandleP);
+	*semHandleP = NULL;
+	return(0);
+}
+
+int32 OSS_SemWait(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle, int32 msec)
+{
+	(void)osHdl; (void)msec;
+	/* never blocks: nobody else could signal */
+	if (semHandle->count == 0)
+		return(ERR_OSS_TIMEOUT);
+	semHandle->count--;
+	return(0);
+}
+
+int32 OSS_SemSignal(OSS_HANDLE *osHdl, OSS_SEM_HANDLE *semHandle)
+{
+	(void)osHdl;
+	semHandle->count = 1;		/* binary */
+	G_hostSemSignals++;
+	return(0);
+}
+
+int32 OSS_SigCreate(OSS_HANDLE *osHdl, int32 value,
+					OSS_SIG_HANDLE **sigHandleP)
+{
+	(void)osHdl;
+	if ((*sigHandleP = calloc(1, sizeof(OSS_SIG_HANDLE))) == NULL)
+		return(ERR_OSS_MEM_ALLOC);
+	(*sigHandleP)->sigNo = value;
+	return(0);
+}
+
+int32 OSS_SigRemove(OSS_HANDLE *osHdl, OSS_SIG_HANDLE **sigHandleP)
+{
+	(void)osHdl;
+	free(*sigHandleP);
+	*sigHandleP = NULL;
+	return(0);
+}
+
+int32 OSS_SigSend(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle)
+{
+	(void)osHdl; (void)sigHandle;
+	G_hostSigSends++;
+	return(0);
+}
+
+int32 OSS_SigInfo(OSS_HANDLE *osHdl, OSS_SIG_HANDLE *sigHandle,
+				  int32 *signalNbrP, int32 *pidP)
+{
+	(void)osHdl;
+	*signalNbrP = sigHandle->sigNo;
+	*pidP = 0;
+	return(0);
+}
+
+OSS_IRQ_STATE OSS_IrqMaskR(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHandle)
+{
+	(void)osHdl; (void)irqHandle;
+	G_hostIrqMasks++;
+	return(0);
+}
+
+void OSS_IrqRestore(OSS_HANDLE *osHdl, OSS_IRQ_HANDLE *irqHandle,
+					OSS_IRQ_STATE oldState)
+{
+	(void)osHdl; (void)irqHandle; (void)oldState;
+}
+
+int32 OSS_AlarmCreate(OSS_HANDLE *osHdl, void (*funct)(void *arg),
+					  void *arg, OSS_ALARM_HANDLE **alarmP)
+{
+	(void)osHdl;
+	if ((*alarmP = calloc(1, sizeof(OSS_ALARM_HANDLE))) == NULL)
+		return(ERR_OSS_MEM_ALLOC);
+	(*alarmP)->funct = funct;
+	(*alarmP)->arg   = arg;
+	G_alarm = *alarmP;
+	return(0);
+}
+
+int32 OSS_AlarmRemove(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE **alarmP)
+{
+	(void)osHdl;
+	if (G_alarm == *alarmP)
+		G_alarm = NULL;
+	free(*alarmP);
+	*alarmP = NULL;
+	return(0);
+}
+
+int32 OSS_AlarmSet(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm,
+				   u_int32 msec, u_int32 cyclic, u_int32 *realMsecP)
+{
+	(void)osHdl; (void)cyclic;
+	alarm->active = TRUE;
+	*realMsecP = msec;
+	return(0);
+}
+
+int32 OSS_AlarmClear(OSS_HANDLE *osHdl, OSS_ALARM_HANDLE *alarm)
+{
+	(void)osHdl;
+	alarm->active = FALSE;
+	return(0);
+}
+
+int32 OSS_Delay(OSS_HANDLE *osHdl, int32 msec)
+{
+	(void)osHdl;
+	usleep(msec * 1000);
+	return(msec);
+}
+
+int32 OSS_TickGet(OSS_HANDLE *osHdl)
+{
+	struct timespec ts;
+
+	(void)osHdl;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return((int32)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000));
+}
+
+int32 OSS_TickRateGet(OSS_HANDLE *osHdl)
+{
+	(void)osHdl;
+	return(1000);
+}
+
+char *OSS_Ident(void)
+{
+	return("host OSS");
+}
+
+/*-----------------------------------------+
+|  DESC                                    |
++-----------------------------------------*/
+int32 DESC_Init(DESC_SPEC *descSpec, OSS_HANDLE *osHdl,
+				DESC_HANDLE **descHandleP)
+{
+	(void)descSpec; (void)osHdl;
+	*descHandleP = (DESC_HANDLE*)&G_descHdl;
+	return(0);
+}
+
+int32 DESC_Exit(DESC_HANDLE **descHandleP)
+{
+	*descHandleP = NULL;
+	return(0);
+}
+
+int32 DESC_GetUInt32(DESC_HANDLE *descHandle, u_int32 defVal,
+					 u_int32 *valueP, char *keyFmt, ...)
+{
+	char key[DESC_KEY_LEN];
+	va_list ap;
+	u_int32 n;
+
+	(void)descHandle;
+	va_start(ap, keyFmt);
+	vsnprintf(key, sizeof(key), keyFmt, ap);
+	va_end(ap);
+
+	for (n=0; n<G_descKeys; n++) {
+		if (strcmp(G_descKey[n].key, key) == 0) {
+			*valueP = G_descKey[n].value;
+			return(0);
+		}
+	}
+
+	*valueP = defVal;
+	return(ERR_DESC_KEY_NOTFOUND);
+}
+
+int32 DESC_DbgLevelSet(DESC_HANDLE *descHandle, u_int32 dbgLevel)
+{
+	(void)descHandle; (void)dbgLevel;
+	return(0);
+}
+
+char *DESC_Ident(void)
+{
+	return("host DESC");
+}
+
+/*-----------------------------------------+
+|  ID, PLD                                 |
++-----------------------------------------*/
+int32 MCRW_PORT_Init(MCRW_DESC_PORT *desc, OSS_HANDLE *osHdl, void **hdlP)
+{
+	(void)desc; (void)osHdl;
+	*hdlP = &G_mcrw;
+	return(0);
+}
+
+int32 PLD_FLEX10K_LoadDirect(MACCESS *ma, u_int8 *buf, u_int32 size,
+							 int32 flags, void *osh,
+							 void (*msecDelay)(void *osh, u_int32 msec),
+							 u_int32 nonPldBits, int dataBit, int dclkBit,
+							 int confBit, int statBit, int cfgdnBit)
+{
+	(void)ma; (void)buf; (void)size; (void)flags; (void)osh;
+	(void)msecDelay; (void)nonPldBits; (void)dataBit; (void)dclkBit;
+	(void)confBit; (void)statBit; (void)cfgdnBit;
+	return(0);
+}
+
+/*-----------------------------------------+
+|  user-space calls (examples)             |
++-----------------------------------------*/
+MDIS_PATH M_open(char *device) { (void)device; return(-1); }
+int32 M_close(MDIS_PATH path) { (void)path; return(-1); }
+int32 M_getstat(MDIS_PATH path, int32 code, int32 *dataP)
+{
+	(void)path; (void)code; (void)dataP;
+	return(-1);
+}
+int32 M_setstat(MDIS_PATH path, int32 code, INT32_OR_64 data)
+{
+	(void)path; (void)code; (void)data;
+	return(-1);
+}
+char *M_errstring(int32 errCode) { (void)errCode; return("host"); }
+int32 UOS_ErrnoGet(void) { return(0); }
+int32 UOS_Delay(u_int32 msec) { usleep(msec * 1000); return(0); }
+int32 UOS_KeyPressed(void) { return(-1); }
@@ -0,0 +1,64 @@
+/****************************************************************************
+ *
+ *  Description: Host environment of the M72 driver tests/benchmarks
+ *
+ *               The driver source is compiled on the host against the
+ *               stub headers in HOST/MEN. m72_host.c implements the OSS,
+ *               DESC, ID and PLD functions and the simulated register
+ *               file (see maccess.h).
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _M72_HOST_H
+#define _M72_HOST_H
+
+/*-----------------------------------------+
+|  DEFINES                                 |
++-----------------------------------------*/
+#define HOST_REG_SIZE		256		/* simulated address space [bytes] */
+
+/* test result check (counts failures, see HostResult) */
+#define CHECK(cond) \
+	do { if (!(cond)) HostFail(__FILE__, __LINE__, #cond); } while (0)
+
+/*-----------------------------------------+
+|  GLOBALS                                 |
++-----------------------------------------*/
+extern u_int32 G_hostSemSignals;	/* OSS_SemSignal calls */
+extern u_int32 G_hostSigSends;		/* OSS_SigSend calls */
+extern u_int32 G_hostIrqMasks;		/* OSS_IrqMaskR calls */
+
+/* next OSS_MemCopy larger than G_hostMemCopySplit bytes calls the hook
+   after copying G_hostMemCopySplit bytes (simulates an irq) */
+extern void (*G_hostMemCopyHook)(void);
+extern u_int32 G_hostMemCopySplit;
+
+/*-----------------------------------------+
+|  PROTOTYPES                              |
++-----------------------------------------*/
+MACCESS HostMa(void);
+void HostRegReset(void);
+void HostDescClear(void);
+void HostDescSet(const char *key, u_int32 value);
+void HostAlarmFire(void);
+u_int64 HostCycles(void);
+void HostFail(const char *file, int line, const char *cond);
+int HostResult(const char *name);
+
+#endif /* _M72_HOST_H */
@@ -0,0 +1,193 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                 M72_DEFER_TEST                     ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: see
+ *
+ *  Description: Host test of the deferred interrupt work
+ *
+ *               Fills the deferred work queue with Ready interrupts of
+ *               channel 0 and then raises interrupts on a full queue:
+ *               - a channel with pending flags in the last entry must be
+ *                 dropped (counted by M72_DEFER_OVERRUN, M72_FIFO_OVERRUN
+ *                 and the FIFO sequence number), never stored with the
+ *                 value of another interrupt
+ *               - a channel without pending flags in the last entry must
+ *                 be merged with its own value
+ *               - the flags of a dropped interrupt must not be added to
+ *                 the last entry
+ *               After the alarm, every FIFO entry must carry the counter
+ *               value of its own interrupt.
+ *
+ *               Also checks the range of M72_IRQ_DEFER.
+ *
+ *     Required: host compiler (see Makefile)
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* driver is included to reach its static functions */
+#include "../DRIVER/COM/m72_drv.c"
+
+#include "m72_host.h"
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define FIFO_DEPTH		128			/* FIFO entries of channel 0/1 */
+#define VALUE(ch,i)		(((ch) << 16) | (i))	/* counter value of irq i */
+#define SIG_NO			10			/* signal number */
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static void Irq(LL_HANDLE *llHdl, u_int32 irqState, u_int32 i);
+static void FifoCheck(LL_HANDLE *llHdl, u_int32 ch, u_int32 num,
+					  u_int32 first, u_int32 last);
+
+/********************************* main *************************************
+ *
+ *  Description: Run the deferred interrupt work test
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return	       success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(void)
+{
+	LL_HANDLE *llHdl = NULL;
+	MACCESS ma = HostMa();
+	INT32_OR_64 val;
+	u_int32 i, ch, sem;
+
+	HostRegReset();
+	HostDescClear();
+	HostDescSet("CHANNEL_0/FIFO_DEPTH", FIFO_DEPTH);
+	HostDescSet("CHANNEL_1/FIFO_DEPTH", FIFO_DEPTH);
+	CHECK(M72_Init(NULL, NULL, &ma, NULL, NULL, &llHdl) == 0);
+
+	for (ch=0; ch<2; ch++) {
+		CHECK(M72_SetStat(llHdl, M72_ENB_IRQ, ch, 1) == 0);
+		CHECK(M72_SetStat(llHdl, M72_FIFO_EVENTS, ch, M72_INT_READY) == 0);
+	}
+	CHECK(M72_SetStat(llHdl, M72_READ_MODE, 1, M72_READ_WAIT) == 0);
+	CHECK(M72_SetStat(llHdl, M72_SIGSET_COMP, 0, SIG_NO) == 0);
+
+	/*--- period range ---*/
+	CHECK(M72_SetStat(llHdl, M72_IRQ_DEFER, 0, DEFER_PERIOD_MAX + 1) ==
+		  ERR_LL_ILL_PARAM);
+	CHECK(M72_SetStat(llHdl, M72_IRQ_DEFER, 0, -1) == ERR_LL_ILL_PARAM);
+	CHECK(M72_SetStat(llHdl, M72_IRQ_DEFER, 0, 10) == 0);
+	CHECK(M72_GetStat(llHdl, M72_IRQ_DEFER, 0, &val) == 0 && val == 10);
+
+	/*--- fill queue: channel 0 ---*/
+	for (i=0; i<DEFER_DEPTH; i++)
+		Irq(llHdl, READY_PEND(0), i);
+
+	/*--- full queue ---*/
+	sem = G_hostSemSignals;
+
+	/* channel 0 dropped, channel 1 merged */
+	Irq(llHdl, READY_PEND(0) | READY_PEND(1), DEFER_DEPTH);
+	/* Comparator (signal only) must not tag the queued Ready value */
+	Irq(llHdl, COMP_PEND(0), DEFER_DEPTH + 1);
+	/* channel 1 now dropped too */
+	Irq(llHdl, READY_PEND(1), DEFER_DEPTH + 2);
+
+	CHECK(M72_GetStat(llHdl, M72_DEFER_OVERRUN, 0, &val) == 0 && val == 3);
+
+	HostAlarmFire();
+
+	/* channel 0: own values, one lost */
+	FifoCheck(llHdl, 0, DEFER_DEPTH, VALUE(0, 0), VALUE(0, DEFER_DEPTH - 1));
+	CHECK(llHdl->fifo[0].overrun == 1);
+	CHECK(llHdl->fifo[0].seq == DEFER_DEPTH + 1);
+
+	/* channel 1: value of the merged irq, one lost, one wake-up */
+	FifoCheck(llHdl, 1, 1, VALUE(1, DEFER_DEPTH), VALUE(1, DEFER_DEPTH));
+	CHECK(llHdl->fifo[1].overrun == 1);
+	CHECK(llHdl->fifo[1].seq == 2);
+	CHECK(G_hostSemSignals - sem == 1);
+	CHECK(G_hostSigSends == 0);
+
+	CHECK(M72_SetStat(llHdl, M72_IRQ_DEFER, 0, 0) == 0);
+	CHECK(M72_Exit(&llHdl) == 0);
+
+	return(HostResult("m72_defer_test"));
+}
+
+/********************************* Irq **************************************
+ *
+ *  Description: Raise interrupt with counter value VALUE(ch,i) on the
+ *               channels of the pending flags
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl    low-level handle
+ *               irqState pending flags
+ *               i        interrupt number
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void Irq(LL_HANDLE *llHdl, u_int32 irqState, u_int32 i)
+{
+	u_int32 ch;
+
+	for (ch=0; ch<CH_NUMBER; ch++) {
+		G_hostRegs[COUNT_LOW_REG(ch) / 2]  = (u_int16)VALUE(ch, i);
+		G_hostRegs[COUNT_HIGH_REG(ch) / 2] = (u_int16)(VALUE(ch, i) >> 16);
+	}
+	G_hostRegs[IRQ_STATE_REG1 / 2] = (u_int16)irqState;
+	G_hostRegs[IRQ_STATE_REG2 / 2] = (u_int16)(irqState >> 16);
+
+	CHECK(M72_Irq(llHdl) == LL_IRQ_DEVICE);
+}
+
+/********************************* FifoCheck ********************************
+ *
+ *  Description: Check FIFO of channel: num entries, values first..last
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl    low-level handle
+ *               ch       channel
+ *               num      expected entries
+ *               first    value of first entry
+ *               last     value of last entry
+ *  Output.....: -
+ *  Globals....: -
+ ****************************************************************************/
+static void FifoCheck(LL_HANDLE *llHdl, u_int32 ch, u_int32 num,
+					  u_int32 first, u_int32 last)
+{
+	FIFO *fifo = &llHdl->fifo[ch];
+	M72_FIFO_ENTRY *ent;
+	u_int32 n;
+
+	CHECK(fifo->count == num);
+
+	for (n=0; n<fifo->count; n++) {
+		ent = &fifo->buf[(fifo->out + n) % fifo->depth];
+
+		CHECK(ent->value == first + n);
+		CHECK(ent->cause == M72_INT_READY);
+	}
+	CHECK(num == 0 || first + num - 1 == last);
+}
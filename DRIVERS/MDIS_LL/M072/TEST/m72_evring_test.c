@@ -0,0 +1,441 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                 M72_EVRING_TEST                    ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: see
+ *
+ *  Description: Host test and benchmark of the event ring
+ *
+ *               One writer thread fills the ring with EvRingPut (as
+ *               M72_Irq does) while several reader threads read it:
+ *               - direct readers with EvRingRead of example m72_evring
+ *               - copy readers with M72_GetStat(M72_BLK_EVRING) and
+ *                 EvRingRead on the copy
+ *
+ *               Each record carries values derived from its sequence
+ *               number. A reader must only return complete records in
+ *               sequence order, and for every reader the numbers of read
+ *               and lost records must add up to the number of written
+ *               records.
+ *
+ *               The writer writes in bursts of twice the ring size, so
+ *               the readers both read records and detect losses.
+ *
+ *               A further test lets the writer overwrite the oldest record
+ *               while M72_BLK_EVRING copies it (see G_hostMemCopyHook).
+ *
+ *     Required: host compiler, pthreads (see Makefile)
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* driver and example are included to reach their static functions */
+#include "../DRIVER/COM/m72_drv.c"
+#define main M72EvringMain
+#include "../EXAMPLE/M72_EVRING/COM/m72_evring.c"
+#undef main
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "m72_host.h"
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define RECORDS			2000000		/* records written per ring size */
+#define DIRECT_READERS	3			/* EvRingRead on the ring */
+#define COPY_READERS	2			/* EvRingRead on M72_BLK_EVRING copy */
+#define READERS			(DIRECT_READERS + COPY_READERS)
+#define VALUE_K			0x9e3779b1	/* record value = seq * VALUE_K */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+typedef struct {
+	u_int32		copyMode;		/* read M72_BLK_EVRING copy */
+	u_int32		read;			/* read records */
+	u_int32		lost;			/* lost records */
+	u_int32		bad;			/* inconsistent records */
+	u_int32		order;			/* records out of sequence */
+	u_int32		copies;			/* M72_BLK_EVRING calls */
+	int32		error;			/* M72_GetStat error */
+	double		ns;				/* thread run time */
+} READER;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static LL_HANDLE *G_llHdl;
+static volatile u_int32 G_done;
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static double NowNs(void);
+static void RingInit(u_int32 size);
+static void *Writer(void *arg);
+static void *Reader(void *arg);
+static void RecPut(u_int32 seq);
+static int RecCheck(M72_EVRING_REC *rec, u_int32 seq);
+static void RingTest(u_int32 size);
+static void TearTest(void);
+static void PutBench(u_int32 size);
+
+/********************************* main *************************************
+ *
+ *  Description: Run the event ring test for several ring sizes
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return	       success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(void)
+{
+	TearTest();
+	RingTest(16);
+	RingTest(4096);
+	PutBench(4096);
+
+	return(HostResult("m72_evring_test"));
+}
+
+/********************************* NowNs ************************************
+ *
+ *  Description: Get monotonic time [ns]
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return	time
+ *  Globals....: -
+ ****************************************************************************/
+static double NowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return(ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+/********************************* RingInit *********************************
+ *
+ *  Description: Init driver with event ring of given size
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: size	ring size (records)
+ *  Output.....: -
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static void RingInit(u_int32 size)
+{
+	MACCESS ma = HostMa();
+
+	HostRegReset();
+	HostDescClear();
+	HostDescSet("EVRING_SIZE", size);
+
+	CHECK(M72_Init(NULL, NULL, &ma, NULL, NULL, &G_llHdl) == 0);
+	CHECK(G_llHdl->evRing != NULL && G_llHdl->evRing->size == size);
+}
+
+/********************************* RecPut ***********************************
+ *
+ *  Description: Write record with given sequence number (see RecCheck)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: seq	sequence number (must be ring->head)
+ *  Output.....: -
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static void RecPut(u_int32 seq)
+{
+	M72_CNT64 time;
+
+	time.low  = seq;
+	time.high = ~seq;
+	EvRingPut(G_llHdl, seq & 3, seq * VALUE_K, M72_INT_COMP, &time);
+}
+
+/********************************* RecCheck *********************************
+ *
+ *  Description: Check record contents
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: rec	record
+ *               seq	expected sequence number
+ *  Output.....: return	TRUE=consistent
+ *  Globals....: -
+ ****************************************************************************/
+static int RecCheck(M72_EVRING_REC *rec, u_int32 seq)
+{
+	return(rec->seq == seq &&
+		   rec->value == seq * VALUE_K &&
+		   rec->channel == (seq & 3) &&
+		   rec->cause == M72_INT_COMP &&
+		   rec->time == seq &&
+		   rec->timeHigh == ~seq);
+}
+
+/********************************* Writer ***********************************
+ *
+ *  Description: Writer thread: fill ring (in bursts)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: arg	unused
+ *  Output.....: return	NULL
+ *  Globals....: G_llHdl, G_done
+ ****************************************************************************/
+static void *Writer(void *arg)
+{
+	u_int32 seq, burst = G_llHdl->evRing->size * 2;
+
+	(void)arg;
+	for (seq=0; seq<RECORDS; seq++) {
+		RecPut(seq);
+
+		if ((seq % burst) == burst - 1)
+			sched_yield();
+	}
+
+	G_done = TRUE;
+	return(NULL);
+}
+
+/********************************* Reader ***********************************
+ *
+ *  Description: Reader thread: read ring until writer done and ring empty
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: arg	reader (READER)
+ *  Output.....: return	NULL
+ *  Globals....: G_llHdl, G_done
+ ****************************************************************************/
+static void *Reader(void *arg)
+{
+	READER *rd = (READER*)arg;
+	M72_EVRING *ring = G_llHdl->evRing, *copy = NULL;
+	M72_EVRING_REC rec;
+	M_SG_BLOCK blk;
+	u_int32 tail = 0, old, done;
+	int32 ret;
+	double t0 = NowNs();
+
+	if (rd->copyMode) {
+		blk.size = M72_EVRING_SIZE(ring->size);
+		blk.data = copy = (M72_EVRING*)malloc(blk.size);
+		ring = copy;
+	}
+
+	do {
+		done = G_done;
+
+		if (rd->copyMode) {
+			if ((rd->error = M72_GetStat(G_llHdl, M72_BLK_EVRING, 0,
+										 (INT32_OR_64*)&blk)) != 0)
+				break;
+			rd->copies++;
+		}
+
+		for (;;) {
+			old = tail;
+			if ((ret = EvRingRead(ring, &tail, &rec)) == 0)
+				break;
+
+			if (ret < 0) {
+				/* tail must move forward */
+				if ((int32)(tail - old) <= 0)
+					rd->order++;
+				rd->lost += tail - old;
+				continue;
+			}
+
+			if (!RecCheck(&rec, old))
+				rd->bad++;
+			if (tail != old + 1)
+				rd->order++;
+			rd->read++;
+		}
+
+		/* ring empty: let the writer run (single CPU hosts) */
+		sched_yield();
+	} while (!done);
+
+	rd->ns = NowNs() - t0;
+	if (copy)
+		free(copy);
+
+	return(NULL);
+}
+
+/********************************* RingTest *********************************
+ *
+ *  Description: Run writer against all readers, check and print results
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: size	ring size (records)
+ *  Output.....: -
+ *  Globals....: G_llHdl, G_done
+ ****************************************************************************/
+static void RingTest(u_int32 size)
+{
+	pthread_t wrThr, rdThr[READERS];
+	READER rd[READERS];
+	double t0, wrNs;
+	u_int32 n;
+
+	RingInit(size);
+	G_done = FALSE;
+	memset(rd, 0, sizeof(rd));
+
+	for (n=0; n<READERS; n++) {
+		rd[n].copyMode = n >= DIRECT_READERS;
+		pthread_create(&rdThr[n], NULL, Reader, &rd[n]);
+	}
+
+	t0 = NowNs();
+	pthread_create(&wrThr, NULL, Writer, NULL);
+	pthread_join(wrThr, NULL);
+	wrNs = NowNs() - t0;
+
+	for (n=0; n<READERS; n++)
+		pthread_join(rdThr[n], NULL);
+
+	printf("ring size %u: %u records, writer %.1f ns/record\n",
+		   size, RECORDS, wrNs / RECORDS);
+
+	for (n=0; n<READERS; n++) {
+		printf("  %s reader %u: read %8u lost %8u bad %u order %u",
+			   rd[n].copyMode ? "copy  " : "direct", n,
+			   rd[n].read, rd[n].lost, rd[n].bad, rd[n].order);
+		if (rd[n].copyMode)
+			printf(" copies %u", rd[n].copies);
+		if (rd[n].read)
+			printf(" %.1f ns/read", rd[n].ns / rd[n].read);
+		printf("\n");
+
+		CHECK(rd[n].error == 0);
+		CHECK(rd[n].bad == 0);
+		CHECK(rd[n].order == 0);
+		CHECK(rd[n].read + rd[n].lost == RECORDS);
+	}
+
+	CHECK(G_llHdl->evRing->head == RECORDS);
+	CHECK(M72_Exit(&G_llHdl) == 0);
+}
+
+/********************************* TearPut **********************************
+ *
+ *  Description: Write next record (called during M72_BLK_EVRING copy)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static void TearPut(void)
+{
+	RecPut(G_llHdl->evRing->head);
+}
+
+/********************************* TearTest *********************************
+ *
+ *  Description: Overwrite the oldest record while M72_BLK_EVRING copies it
+ *
+ *               The copy is interrupted after the 'seq' field of the
+ *               oldest record, so 'seq' is copied from the old and 'time'
+ *               from the new record. The reader must skip this record.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: -
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static void TearTest(void)
+{
+	M72_EVRING *copy;
+	M72_EVRING_REC rec;
+	M_SG_BLOCK blk;
+	u_int32 size = 16, head = 40, seq, tail, read = 0, lost = 0, bad = 0;
+	int32 ret;
+
+	RingInit(size);
+	for (seq=0; seq<head; seq++)
+		RecPut(seq);
+
+	blk.size = M72_EVRING_SIZE(size);
+	blk.data = copy = (M72_EVRING*)malloc(blk.size);
+
+	G_hostMemCopySplit = (head & (size - 1)) * sizeof(M72_EVRING_REC) +
+		offsetof(M72_EVRING_REC, time);
+	G_hostMemCopyHook = TearPut;
+	CHECK(M72_GetStat(G_llHdl, M72_BLK_EVRING, 0, (INT32_OR_64*)&blk) == 0);
+	CHECK(G_hostMemCopyHook == NULL);
+	CHECK(copy->head == head);
+
+	tail = head - size;
+	while ((ret = EvRingRead(copy, &tail, &rec)) != 0) {
+		if (ret < 0) {
+			lost++;
+			continue;
+		}
+		if (!RecCheck(&rec, tail - 1))
+			bad++;
+		read++;
+	}
+
+	printf("torn copy: read %u lost %u bad %u\n", read, lost, bad);
+	CHECK(bad == 0);
+	CHECK(read == size - 1 && lost == 1);
+	CHECK(tail == head);
+
+	free(copy);
+	CHECK(M72_Exit(&G_llHdl) == 0);
+}
+
+/********************************* PutBench *********************************
+ *
+ *  Description: Measure EvRingPut without readers
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: size	ring size (records)
+ *  Output.....: -
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static void PutBench(u_int32 size)
+{
+	M72_CNT64 time = { 0, 0 };
+	u_int64 c0, c1;
+	u_int32 n;
+
+	RingInit(size);
+
+	c0 = HostCycles();
+	for (n=0; n<RECORDS; n++) {
+		time.low = n;
+		EvRingPut(G_llHdl, n & 3, n, M72_INT_COMP, &time);
+	}
+	c1 = HostCycles();
+
+	printf("EvRingPut: %.1f cycles/record\n", (double)(c1 - c0) / RECORDS);
+
+	CHECK(M72_Exit(&G_llHdl) == 0);
+}
@@ -0,0 +1,318 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                  M72_IRQ_BENCH                     ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: see
+ *
+ *  Description: Host benchmark of the interrupt service routine
+ *
+ *               Runs M72_Irq against the simulated register file (pending
+ *               bits set in IRQ_STATE_REG1/2 before each call) for several
+ *               scenarios, pretrigger mode off, and compares it with the
+ *               reference routines of m72_irq_ref.c:
+ *
+ *               base   original driver (signals/read semaphores only)
+ *               pre    before the pretrigger merge
+ *               loop   per-channel loops, before the pending-bit dispatch
+ *               irq    current M72_Irq
+ *
+ *               Reported per routine: cycles per call (best of several
+ *               runs), cycles per pending event and register accesses per
+ *               call. 'base' lacks FIFO and timebase support and is not run
+ *               for these scenarios. All routines must send the same
+ *               signals. With several signals per call, all routines are
+ *               bound by the signal counter of the host OSS_SigSend.
+ *
+ *               Built twice (see Makefile): m72_irq_bench and, with
+ *               M72_IRQ_PROFILE, m72_irq_bench_prof. The 'timebase'
+ *               scenarios of both show the overhead of the ISR profile.
+ *
+ *               The timestamp is a plain counter here (M72_TIMESTAMP), so
+ *               the host clock does not dominate the results.
+ *
+ *     Required: host compiler (see Makefile)
+ *     Switches: M72_IRQ_PROFILE	ISR profile (driver switch)
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <MEN/men_typs.h>
+
+/* platform timestamp: counter (see m72_drv.c) */
+static u_int32 G_stamp;
+#define M72_TIMESTAMP(llHdl)		(G_stamp++)
+#define M72_TIMESTAMP_RATE(llHdl)	1000000
+
+/* driver and reference routines are included to reach static functions */
+#include "../DRIVER/COM/m72_drv.c"
+#include "m72_irq_ref.c"
+
+#include <stdio.h>
+#include <string.h>
+#include "m72_host.h"
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define CALLS		20000		/* ISR calls per run */
+#define RUNS		50			/* runs per routine (best taken) */
+#define SIG_NO		10			/* signal number */
+
+#define S_FIFO		0x01		/* scenario: FIFO on channel 0 */
+#define S_SIG		0x02		/* scenario: signals installed */
+#define S_TB		0x04		/* scenario: timebase channel 3 */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+typedef struct {
+	const char	*name;
+	u_int32		irqState;		/* pending bits */
+	u_int32		flags;			/* S_xxx */
+} SCENARIO;
+
+typedef struct {
+	const char	*name;
+	int32		(*irq)(LL_HANDLE *llHdl);
+	u_int32		features;		/* supported S_xxx */
+} ROUTINE;
+
+typedef struct {
+	double		cyc;			/* cycles per call */
+	double		rd;				/* register reads per call */
+	double		wr;				/* register writes per call */
+	u_int32		sig;			/* signals per call */
+} RESULT;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static const SCENARIO G_scen[] = {
+	{ "reject",       0x00000000, 0 },
+	{ "ready",        0x00000001, 0 },
+	{ "ready+sig",    0x00000001, S_SIG },
+	{ "4ch ready+sig",0x01010101, S_SIG },
+	{ "4ch rdy/cmp",  0x03030303, S_SIG },
+	{ "fifo",         0x00000001, S_FIFO },
+	{ "timebase",     0x00000001, S_SIG | S_TB },
+	{ "timebase fifo",0x00000001, S_SIG | S_TB | S_FIFO },
+};
+
+static const ROUTINE G_rout[] = {
+	{ "base", RefIrqBase, S_SIG },
+	{ "pre",  RefIrqPre,  S_SIG | S_FIFO | S_TB },
+	{ "loop", RefIrqLoop, S_SIG | S_FIFO | S_TB },
+	{ "irq",  M72_Irq,    S_SIG | S_FIFO | S_TB },
+};
+
+#define ROUTINES	(sizeof(G_rout)/sizeof(*G_rout))
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static LL_HANDLE *Setup(const SCENARIO *sc);
+static void Measure(const SCENARIO *sc, RESULT *res);
+
+/********************************* main *************************************
+ *
+ *  Description: Run all scenarios with all routines
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: -
+ *  Output.....: return	       success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(void)
+{
+	RESULT res[ROUTINES];
+	u_int32 s, r, events, sigRef;
+
+#ifdef M72_IRQ_PROFILE
+	printf("M72_Irq with M72_IRQ_PROFILE\n");
+#else
+	printf("M72_Irq without M72_IRQ_PROFILE\n");
+#endif
+	printf("%-14s %-5s %10s %10s %6s %6s\n",
+		   "scenario", "isr", "cyc/call", "cyc/event", "rd", "wr");
+
+	for (s=0; s<sizeof(G_scen)/sizeof(*G_scen); s++) {
+		events = 0;
+		for (r=0; r<32; r++)
+			events += (G_scen[s].irqState >> r) & 1;
+
+		Measure(&G_scen[s], res);
+
+		sigRef = 0xffffffff;
+
+		for (r=0; r<ROUTINES; r++) {
+			if (G_scen[s].flags & ~G_rout[r].features)
+				continue;
+
+			printf("%-14s %-5s %10.1f ", G_scen[s].name, G_rout[r].name,
+				   res[r].cyc);
+			if (events)
+				printf("%10.1f ", res[r].cyc / events);
+			else
+				printf("%10s ", "-");
+			printf("%6.1f %6.1f\n", res[r].rd, res[r].wr);
+
+			/* same signals from all routines */
+			if (sigRef == 0xffffffff)
+				sigRef = res[r].sig;
+			CHECK(res[r].sig == sigRef);
+		}
+	}
+
+	return(HostResult("m72_irq_bench"));
+}
+
+/********************************* Setup ************************************
+ *
+ *  Description: Init driver for scenario
+ *
+ *               Interrupts of all channels enabled.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: sc       scenario
+ *  Output.....: return   low-level handle
+ *  Globals....: -
+ ****************************************************************************/
+static LL_HANDLE *Setup(const SCENARIO *sc)
+{
+	LL_HANDLE *llHdl = NULL;
+	MACCESS ma = HostMa();
+	int32 ch;
+
+	HostRegReset();
+	HostDescClear();
+	if (sc->flags & S_FIFO)
+		HostDescSet("CHANNEL_0/FIFO_DEPTH", 16);
+
+	CHECK(M72_Init(NULL, NULL, &ma, NULL, NULL, &llHdl) == 0);
+
+	for (ch=0; ch<CH_NUMBER; ch++) {
+		CHECK(M72_SetStat(llHdl, M72_ENB_IRQ, ch, 1) == 0);
+
+		if (sc->flags & S_SIG) {
+			CHECK(M72_SetStat(llHdl, M72_SIGSET_READY, ch, SIG_NO) == 0);
+			CHECK(M72_SetStat(llHdl, M72_SIGSET_COMP, ch, SIG_NO) == 0);
+		}
+	}
+
+	if (sc->flags & S_FIFO)
+		CHECK(M72_SetStat(llHdl, M72_FIFO_EVENTS, 0, M72_INT_READY) == 0);
+	if (sc->flags & S_TB) {
+		CHECK(M72_SetStat(llHdl, M72_CNT_MODE, 3, M72_MODE_TIMER) == 0);
+		CHECK(M72_SetStat(llHdl, M72_TIMEBASE, 3, 3) == 0);
+	}
+
+	return(llHdl);
+}
+
+/********************************* Measure **********************************
+ *
+ *  Description: Measure all routines in scenario
+ *
+ *               Each routine gets its own low-level handle. The runs of
+ *               the routines are interleaved, so clock changes of the host
+ *               hit all of them alike.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: sc       scenario
+ *  Output.....: res      results per routine (unsupported ones untouched):
+ *                        cyc  cycles per call (best run)
+ *                        rd   register reads per call
+ *                        wr   register writes per call (without the two
+ *                             writes setting the pending bits)
+ *                        sig  signals sent per call
+ *  Globals....: -
+ ****************************************************************************/
+static void Measure(const SCENARIO *sc, RESULT *res)
+{
+	LL_HANDLE *llHdl[ROUTINES];
+	u_int32 n, r, run, rd[ROUTINES], wr[ROUTINES], sig[ROUTINES], fail = 0;
+	u_int64 c0, cyc, best[ROUTINES];
+	int32 (*irq)(LL_HANDLE *llHdl);
+	int32 ret, exp = sc->irqState ? LL_IRQ_DEVICE : LL_IRQ_DEV_NOT;
+	LL_HANDLE *h;
+
+	for (r=0; r<ROUTINES; r++) {
+		llHdl[r] = NULL;
+		if (sc->flags & ~G_rout[r].features)
+			continue;
+
+		llHdl[r] = Setup(sc);
+		rd[r] = wr[r] = sig[r] = 0;
+		best[r] = ~0ULL;
+	}
+
+	for (run=0; run<RUNS; run++) {
+		for (r=0; r<ROUTINES; r++) {
+			if ((h = llHdl[r]) == NULL)
+				continue;
+
+			irq = G_rout[r].irq;
+			rd[r]  -= G_hostRegReads;
+			wr[r]  -= G_hostRegWrites;
+			sig[r] -= G_hostSigSends;
+
+			c0 = HostCycles();
+			for (n=0; n<CALLS; n++) {
+				G_hostRegs[IRQ_STATE_REG1 / 2] = (u_int16)sc->irqState;
+				G_hostRegs[IRQ_STATE_REG2 / 2] = (u_int16)(sc->irqState >> 16);
+
+				ret = irq(h);
+				fail += (ret != exp);
+
+				/* keep FIFO from overrunning */
+				if (h->fifo[0].depth)
+					h->fifo[0].count = h->fifo[0].out = h->fifo[0].in = 0;
+			}
+			cyc = HostCycles() - c0;
+
+			rd[r]  += G_hostRegReads;
+			wr[r]  += G_hostRegWrites;
+			sig[r] += G_hostSigSends;
+
+			if (cyc < best[r])
+				best[r] = cyc;
+		}
+	}
+
+	CHECK(fail == 0);
+
+	for (r=0; r<ROUTINES; r++) {
+		if (llHdl[r] == NULL)
+			continue;
+
+		res[r].cyc = (double)best[r] / CALLS;
+		res[r].rd  = (double)rd[r] / (RUNS * CALLS);
+		res[r].wr  = (double)wr[r] / (RUNS * CALLS);
+		res[r].sig = sig[r] / (RUNS * CALLS);
+
+#ifdef M72_IRQ_PROFILE
+		/* profile covers every call with timebase */
+		if (G_rout[r].irq == M72_Irq && (sc->flags & S_TB))
+			CHECK(llHdl[r]->prof.count == RUNS * CALLS);
+#endif
+
+		CHECK(M72_Exit(&llHdl[r]) == 0);
+	}
+}
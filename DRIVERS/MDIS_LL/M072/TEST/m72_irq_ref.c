@@ -0,0 +1,478 @@
+/****************************************************************************
+ *
+ *  Description: Reference interrupt routines for m72_irq_bench
+ *
+ *               Former versions of M72_Irq, compiled against the current
+ *               LL_HANDLE (included by m72_irq_bench.c after the driver):
+ *
+ *               RefIrqBase  original driver (before event storage,
+ *                           timestamps and pretrigger mode)
+ *               RefIrqPre   before the pretrigger merge
+ *               RefIrqLoop  per-channel loops (before the pending-bit
+ *                           dispatch)
+ *
+ *               The bodies are kept as they were, only renamed.
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/******************************** RefIrqBase ********************************
+ *
+ *  Description: Original M72_Irq (signals and read semaphores only)
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl    low-level handle
+ *  Output.....: return   LL_IRQ_DEVICE, LL_IRQ_DEV_NOT
+ *  Globals....: -
+ ****************************************************************************/
+static int32 RefIrqBase(
+   LL_HANDLE *llHdl
+)
+{
+	u_int32 n;
+	u_int32 irq_state, bitmask = 0x1f;
+
+    IDBGWRT_1((DBH, ">>> M72_Irq:\n"));
+
+	/*-------------------------------+ 
+	|  read/reset pending irq flags  | 
+	|  and update shadow registers   |
+	+-------------------------------*/
+	irq_state = ( (MREAD_D16(llHdl->ma, IRQ_STATE_REG1)) | 
+		          (u_int32)(MREAD_D16(llHdl->ma, IRQ_STATE_REG2) << 16) );
+
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			llHdl->regIntStatChan[n] |= ( (irq_state >> (n<<3)) & bitmask ); /* update shadow reg. */
+		} 
+		else {
+			llHdl->regIntStatChan[n] = 0;		/* set shadow register to zero */
+			irq_state &= ~(bitmask << (n<<3));  /* irqen = 0 -> irqstate is not relevant now */
+		}
+	}
+	
+    /* reset irq flags */
+	MWRITE_D16(llHdl->ma, IRQ_STATE_REG1, (u_int16)irq_state);
+	MWRITE_D16(llHdl->ma, IRQ_STATE_REG2, (u_int16)(irq_state>>16));
+
+	/* no interrupt pending ? */
+	if (irq_state == 0)
+		return(LL_IRQ_DEV_NOT);		/* say: not caused by device */
+
+#ifdef DBG
+	/* print pending flags */
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			IDBGWRT_2((DBH," %d=%c%c%c%c%c", n,
+				   (irq_state & READY_PEND(n)  ? 'R':'.'),
+				   (irq_state & COMP_PEND(n)   ? 'C':'.'),
+				   (irq_state & CYBW_PEND(n)   ? 'Y':'.'),
+				   (irq_state & LBREAK_PEND(n) ? 'L':'.'),
+				   (irq_state & XIN2_PEND(n)   ? 'X':'.')));
+		}
+	}	
+	DBGWRT_2((DBH,"\n"));
+#endif
+
+	/*------------------------------------------------------+ 
+	|  if IRQEN = 1 for channel: send signals if installed  |
+	+------------------------------------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			/* Ready  irq ? */
+			if (irq_state & READY_PEND(n)) {  
+				/* send signal if installed */
+				if (llHdl->sigHdl[n][0]) {
+					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][0]);
+				}
+				/* handle read mode */
+				if (llHdl->readMode[n] == M72_READ_WAIT) {
+					OSS_SemSignal(llHdl->osHdl, llHdl->readSemHdl[n]);
+				}
+			}
+
+			/* Comparator irq ? */
+			if ((irq_state & COMP_PEND(n)) && llHdl->sigHdl[n][1])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][1]);
+
+			/* Carry/Borrow irq ? */
+			if ((irq_state & CYBW_PEND(n)) && llHdl->sigHdl[n][2])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][2]);
+
+			/* Line-Break irq ? */
+			if (irq_state & LBREAK_PEND(n)) {
+				/* send signal if installed */
+				if (llHdl->sigHdl[n][3]) {
+					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][3]);
+				}
+				/* disable Line-Break irq */
+				llHdl->lbreakIrq[n] = 0;
+				llHdl->regIrqCtrl[n] &= ~LBREAK_ENB;
+				MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(n), llHdl->regIrqCtrl[n]);
+			}
+		
+			/* xIN2 Edge irq ? */
+			if ((irq_state & XIN2_PEND(n)) && llHdl->sigHdl[n][4])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][4]);
+		}
+	}	
+
+	llHdl->irqCount++;			
+	return(LL_IRQ_DEVICE);		/* say: caused by device */
+}
+
+/******************************** RefIrqPre *********************************
+ *
+ *  Description: M72_Irq before the pretrigger merge
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl    low-level handle
+ *  Output.....: return   LL_IRQ_DEVICE, LL_IRQ_DEV_NOT
+ *  Globals....: -
+ ****************************************************************************/
+static int32 RefIrqPre(
+   LL_HANDLE *llHdl
+)
+{
+	u_int32 n, i;
+	u_int32 irq_state, bitmask = 0x1f;
+	u_int32 cause, events, value, queued = FALSE;
+	M72_CNT64 stamp;
+
+	stamp.low  = M72_TIMESTAMP(llHdl);
+	stamp.high = 0;
+
+    IDBGWRT_1((DBH, ">>> M72_Irq:\n"));
+
+	/*-------------------------------+ 
+	|  read/reset pending irq flags  | 
+	|  and update shadow registers   |
+	+-------------------------------*/
+	irq_state = ( (MREAD_D16(llHdl->ma, IRQ_STATE_REG1)) | 
+		          (u_int32)(MREAD_D16(llHdl->ma, IRQ_STATE_REG2) << 16) );
+
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			llHdl->regIntStatChan[n] |= ( (irq_state >> (n<<3)) & bitmask ); /* update shadow reg. */
+		} 
+		else {
+			llHdl->regIntStatChan[n] = 0;		/* set shadow register to zero */
+			irq_state &= ~(bitmask << (n<<3));  /* irqen = 0 -> irqstate is not relevant now */
+		}
+	}
+	
+    /* reset irq flags */
+	MWRITE_D16(llHdl->ma, IRQ_STATE_REG1, (u_int16)irq_state);
+	MWRITE_D16(llHdl->ma, IRQ_STATE_REG2, (u_int16)(irq_state>>16));
+
+	/* no interrupt pending ? */
+	if (irq_state == 0)
+		return(LL_IRQ_DEV_NOT);		/* say: not caused by device */
+
+#ifdef DBG
+	/* print pending flags */
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			IDBGWRT_2((DBH," %d=%c%c%c%c%c", n,
+				   (irq_state & READY_PEND(n)  ? 'R':'.'),
+				   (irq_state & COMP_PEND(n)   ? 'C':'.'),
+				   (irq_state & CYBW_PEND(n)   ? 'Y':'.'),
+				   (irq_state & LBREAK_PEND(n) ? 'L':'.'),
+				   (irq_state & XIN2_PEND(n)   ? 'X':'.')));
+		}
+	}	
+	DBGWRT_2((DBH,"\n"));
+#endif
+
+	/*-------------------------------+ 
+	|  update 64-bit counter         | 
+	|  extensions and timestamp      |
+	+-------------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n] && llHdl->ext64[n] && (irq_state & CYBW_PEND(n)))
+			Ext64Wrap(llHdl, n);
+	}
+
+	if (llHdl->tbChan != M72_TIMEBASE_OFF)
+		Ext64Latch(llHdl, llHdl->tbChan, &stamp);
+
+	/*------------------------------------------------------+ 
+	|  if IRQEN = 1 for channel: send signals if installed  |
+	+------------------------------------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			/* load next cam position */
+			if ((irq_state & COMP_PEND(n)) && llHdl->cam[n].mode)
+				CamNext(llHdl, n);
+
+			/* store counter latch in FIFO/event ring/event queue */
+			cause  = (irq_state >> (n<<3)) & CHAN_PEND_MASK;
+			events = llHdl->capture[n] ? M72_INT_XIN2 : llHdl->fifo[n].events;
+
+			/* store time of irq events */
+			for (i=0; i<SIG_COUNT; i++) {
+				if (cause & (1 << i))
+					llHdl->evTime[n][i] = stamp.low;
+			}
+
+			if (llHdl->readMode[n] == M72_READ_QUEUE || llHdl->continuous[n])
+				events |= M72_INT_READY;
+
+			if ((cause & events) &&
+				(llHdl->fifo[n].depth || llHdl->evRing || llHdl->evq.depth)) {
+				value  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(n));
+				value |= (u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(n)) << 16;
+
+				if (llHdl->fifo[n].depth) {
+					FifoPut(llHdl, n, value, cause, &stamp);
+
+					/* wake up queued read */
+					if (llHdl->readMode[n] == M72_READ_QUEUE)
+						OSS_SemSignal(llHdl->osHdl, llHdl->readSemHdl[n]);
+				}
+				if (llHdl->evRing)
+					EvRingPut(llHdl, n, value, cause, &stamp);
+				if (llHdl->evq.depth) {
+					EvQueuePut(llHdl, n, value, cause, &stamp);
+					queued = TRUE;
+				}
+			}
+
+			/* Ready  irq ? */
+			if (irq_state & READY_PEND(n)) {  
+				/* restart continuous measurement */
+				if (llHdl->continuous[n])
+					MeasStart(llHdl, n);
+
+				/* send signal if installed */
+				if (llHdl->sigHdl[n][0]) {
+					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][0]);
+				}
+				/* handle read mode */
+				if (llHdl->readMode[n] == M72_READ_WAIT) {
+					OSS_SemSignal(llHdl->osHdl, llHdl->readSemHdl[n]);
+				}
+			}
+
+			/* Comparator irq ? */
+			if ((irq_state & COMP_PEND(n)) && llHdl->sigHdl[n][1])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][1]);
+
+			/* Carry/Borrow irq ? */
+			if ((irq_state & CYBW_PEND(n)) && llHdl->sigHdl[n][2])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][2]);
+
+			/* Line-Break irq ? */
+			if (irq_state & LBREAK_PEND(n)) {
+				/* send signal if installed */
+				if (llHdl->sigHdl[n][3]) {
+					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][3]);
+				}
+				/* disable Line-Break irq */
+				llHdl->lbreakIrq[n] = 0;
+				llHdl->regIrqCtrl[n] &= ~LBREAK_ENB;
+				MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(n), llHdl->regIrqCtrl[n]);
+			}
+		
+			/* xIN2 Edge irq ? */
+			if ((irq_state & XIN2_PEND(n)) && llHdl->sigHdl[n][4])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][4]);
+		}
+	}	
+
+	/* wake up event queue reader */
+	if (queued)
+		OSS_SemSignal(llHdl->osHdl, llHdl->evq.semHdl);
+
+	llHdl->irqCount++;			
+	return(LL_IRQ_DEVICE);		/* say: caused by device */
+}
+
+/******************************** RefIrqLoop ********************************
+ *
+ *  Description: M72_Irq with per-channel loops
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: llHdl    low-level handle
+ *  Output.....: return   LL_IRQ_DEVICE, LL_IRQ_DEV_NOT
+ *  Globals....: -
+ ****************************************************************************/
+static int32 RefIrqLoop(
+   LL_HANDLE *llHdl
+)
+{
+	u_int32 n, i;
+	u_int32 irq_state = 0, mask = llHdl->irqEnbMask;
+	u_int32 cause, events, value, queued = FALSE;
+	M72_CNT64 stamp;
+
+    IDBGWRT_1((DBH, ">>> M72_Irq:\n"));
+
+	/*-------------------------------+ 
+	|  read pending irq flags of     | 
+	|  enabled channels only         |
+	+-------------------------------*/
+	if (mask & 0xffff)
+		irq_state  = MREAD_D16(llHdl->ma, IRQ_STATE_REG1);
+	if (mask >> 16)
+		irq_state |= (u_int32)MREAD_D16(llHdl->ma, IRQ_STATE_REG2) << 16;
+
+	/* irqen = 0 -> irqstate is not relevant now */
+	irq_state &= mask;
+
+	/* no interrupt pending ? */
+	if (irq_state == 0) {
+		llHdl->irqReject++;
+		return(LL_IRQ_DEV_NOT);		/* say: not caused by device */
+	}
+
+	stamp.low  = M72_TIMESTAMP(llHdl);
+	stamp.high = 0;
+
+    /* reset irq flags */
+	if (irq_state & 0xffff)
+		MWRITE_D16(llHdl->ma, IRQ_STATE_REG1, (u_int16)irq_state);
+	if (irq_state >> 16)
+		MWRITE_D16(llHdl->ma, IRQ_STATE_REG2, (u_int16)(irq_state>>16));
+
+	/* update shadow registers */
+	for (n=0; n<CH_NUMBER; n++)
+		llHdl->regIntStatChan[n] |= (u_int8)(irq_state >> (n<<3));
+
+	/* pretrigger mode: preload edge timers first */
+	if (llHdl->ptActive)
+		PretrigIrq(llHdl, irq_state);
+
+#ifdef DBG
+	/* print pending flags */
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			IDBGWRT_2((DBH," %d=%c%c%c%c%c", n,
+				   (irq_state & READY_PEND(n)  ? 'R':'.'),
+				   (irq_state & COMP_PEND(n)   ? 'C':'.'),
+				   (irq_state & CYBW_PEND(n)   ? 'Y':'.'),
+				   (irq_state & LBREAK_PEND(n) ? 'L':'.'),
+				   (irq_state & XIN2_PEND(n)   ? 'X':'.')));
+		}
+	}	
+	DBGWRT_2((DBH,"\n"));
+#endif
+
+	/*-------------------------------+ 
+	|  update 64-bit counter         | 
+	|  extensions and timestamp      |
+	+-------------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n] && llHdl->ext64[n] && (irq_state & CYBW_PEND(n)))
+			Ext64Wrap(llHdl, n);
+	}
+
+	if (llHdl->tbChan != M72_TIMEBASE_OFF)
+		Ext64Latch(llHdl, llHdl->tbChan, &stamp);
+
+	/*------------------------------------------------------+ 
+	|  if IRQEN = 1 for channel: send signals if installed  |
+	+------------------------------------------------------*/
+	for (n=0; n<CH_NUMBER; n++) {
+		if (llHdl->enbIrq[n]) {
+			/* load next cam position */
+			if ((irq_state & COMP_PEND(n)) && llHdl->cam[n].mode)
+				CamNext(llHdl, n);
+
+			/* store counter latch in FIFO/event ring/event queue */
+			cause  = (irq_state >> (n<<3)) & CHAN_PEND_MASK;
+			events = llHdl->capture[n] ? M72_INT_XIN2 : llHdl->fifo[n].events;
+
+			/* store time of irq events */
+			for (i=0; i<SIG_COUNT; i++) {
+				if (cause & (1 << i))
+					llHdl->evTime[n][i] = stamp.low;
+			}
+
+			if (llHdl->readMode[n] == M72_READ_QUEUE || llHdl->continuous[n])
+				events |= M72_INT_READY;
+
+			if ((cause & events) &&
+				(llHdl->fifo[n].depth || llHdl->evRing || llHdl->evq.depth)) {
+				value  = MREAD_D16(llHdl->ma, COUNT_LOW_REG(n));
+				value |= (u_int32)MREAD_D16(llHdl->ma, COUNT_HIGH_REG(n)) << 16;
+
+				if (llHdl->fifo[n].depth) {
+					FifoPut(llHdl, n, value, cause, &stamp);
+
+					/* wake up queued read */
+					if (llHdl->readMode[n] == M72_READ_QUEUE)
+						OSS_SemSignal(llHdl->osHdl, llHdl->readSemHdl[n]);
+				}
+				if (llHdl->evRing)
+					EvRingPut(llHdl, n, value, cause, &stamp);
+				if (llHdl->evq.depth) {
+					EvQueuePut(llHdl, n, value, cause, &stamp);
+					queued = TRUE;
+				}
+			}
+
+			/* Ready  irq ? */
+			if (irq_state & READY_PEND(n)) {  
+				/* restart continuous measurement */
+				if (llHdl->continuous[n])
+					MeasStart(llHdl, n);
+
+				/* send signal if installed */
+				if (llHdl->sigHdl[n][0]) {
+					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][0]);
+				}
+				/* handle read mode */
+				if (llHdl->readMode[n] == M72_READ_WAIT) {
+					OSS_SemSignal(llHdl->osHdl, llHdl->readSemHdl[n]);
+				}
+			}
+
+			/* Comparator irq ? */
+			if ((irq_state & COMP_PEND(n)) && llHdl->sigHdl[n][1])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][1]);
+
+			/* Carry/Borrow irq ? */
+			if ((irq_state & CYBW_PEND(n)) && llHdl->sigHdl[n][2])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][2]);
+
+			/* Line-Break irq ? */
+			if (irq_state & LBREAK_PEND(n)) {
+				/* send signal if installed */
+				if (llHdl->sigHdl[n][3]) {
+					OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][3]);
+				}
+				/* disable Line-Break irq */
+				llHdl->lbreakIrq[n] = 0;
+				llHdl->regIrqCtrl[n] &= ~LBREAK_ENB;
+				MWRITE_D16(llHdl->ma, IRQ_CTRL_REG(n), llHdl->regIrqCtrl[n]);
+			}
+		
+			/* xIN2 Edge irq ? */
+			if ((irq_state & XIN2_PEND(n)) && llHdl->sigHdl[n][4])
+				OSS_SigSend(llHdl->osHdl, llHdl->sigHdl[n][4]);
+		}
+	}	
+
+	/* wake up event queue reader */
+	if (queued)
+		OSS_SemSignal(llHdl->osHdl, llHdl->evq.semHdl);
+
+	llHdl->irqCount++;			
+	return(LL_IRQ_DEVICE);		/* say: caused by device */
+}
@@ -0,0 +1,329 @@
+/****************************************************************************
+ ************                                                    ************
+ ************                 M72_PRED_BENCH                     ************
+ ************                                                    ************
+ ****************************************************************************
+ *
+ *       Author: see
+ *
+ *  Description: Host benchmark of the pretrigger period predictors
+ *
+ *               Feeds period sequences through each M72_PRED_xxx mode
+ *               (PretrigPredReset, PretrigPredict) for several
+ *               M72_PRETRIG_PRED_K values and reports the prediction
+ *               error of the next period and of the clear edge
+ *               (PretrigFrac), mean and max, plus the cycles per
+ *               PretrigPredict and per PretrigIrq (period latch read
+ *               from the simulated register file, preloads written).
+ *
+ *               The error is also taken from the driver's statistics
+ *               (M72_BLK_PRETRIG_STAT sums) and must match.
+ *
+ *               Sequences: built-in synthetic ones, or a recorded one
+ *               from a file (one period [ticks] per line):
+ *
+ *                 m72_pred_bench [<file>]
+ *
+ *     Required: host compiler (see Makefile)
+ *     Switches: -
+ *
+ *---------------------------------------------------------------------------
+ * Copyright 2010-2019, MEN Mikro Elektronik GmbH
+ ****************************************************************************/
+/*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* driver is included to reach its static functions */
+#include "../DRIVER/COM/m72_drv.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "m72_host.h"
+
+/*--------------------------------------+
+|   DEFINES                             |
++--------------------------------------*/
+#define SEQ_LEN		20000		/* periods per synthetic sequence */
+#define SEQ_MAX		1000000		/* max. periods of recorded sequence */
+#define PERIOD		100000		/* nominal period [ticks] */
+#define BAND		(M72_PRETRIG_FRAC_ONE / 8)	/* outlier band */
+
+/*--------------------------------------+
+|   TYPEDEFS                            |
++--------------------------------------*/
+typedef struct {
+	const char	*name;
+	u_int32		*cnt;			/* periods */
+	u_int32		num;			/* number of periods */
+} PERIODS;
+
+typedef struct {
+	u_int32		mode;			/* M72_PRED_xxx */
+	const char	*name;
+} MODE;
+
+/*--------------------------------------+
+|   GLOBALS                             |
++--------------------------------------*/
+static LL_HANDLE *G_llHdl;
+static u_int32 G_rand = 12345;
+
+static const MODE G_mode[] = {
+	{ M72_PRED_LAST,  "LAST"  },
+	{ M72_PRED_AVG,   "AVG"   },
+	{ M72_PRED_EXP,   "EXP"   },
+	{ M72_PRED_TREND, "TREND" },
+};
+
+static const u_int32 G_k[] = { 1, 2, 4 };
+
+/*--------------------------------------+
+|   PROTOTYPES                          |
++--------------------------------------*/
+static int32 Rand(int32 range);
+static PERIODS *PeriodMake(const char *name);
+static PERIODS *PeriodLoad(const char *file);
+static double Run(PERIODS *seq, u_int32 mode, u_int32 k, const char *modeName);
+
+/********************************* main *************************************
+ *
+ *  Description: Run all sequences through all predictors
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: argc, argv	   command line arguments/counter
+ *  Output.....: return	       success (0) or error (1)
+ *  Globals....: -
+ ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	static const char *synth[] = {
+		"constant", "jitter", "ramp", "drift", "outliers", "step"
+	};
+	MACCESS ma = HostMa();
+	PERIODS *seq;
+	double mean[4];
+	u_int32 s, m, k;
+
+	HostRegReset();
+	HostDescClear();
+	if (M72_Init(NULL, NULL, &ma, NULL, NULL, &G_llHdl) != 0) {
+		printf("*** M72_Init failed\n");
+		return(1);
+	}
+
+	printf("%-9s %-5s %s %10s %8s %10s %8s %5s %8s %8s\n",
+		   "sequence", "mode", "k", "err.mean", "err.max", "edge.mean",
+		   "edge.max", "outl", "cyc.pred", "cyc.irq");
+
+	for (s=0; s<(argc > 1 ? 1 : sizeof(synth)/sizeof(*synth)); s++) {
+		if ((seq = argc > 1 ? PeriodLoad(argv[1]) : PeriodMake(synth[s])) == NULL)
+			return(1);
+
+		for (k=0; k<sizeof(G_k)/sizeof(*G_k); k++) {
+			for (m=0; m<sizeof(G_mode)/sizeof(*G_mode); m++)
+				mean[m] = Run(seq, G_mode[m].mode, G_k[k], G_mode[m].name);
+
+			/* a linear trend is only followed by the trend predictor */
+			if (strcmp(seq->name, "ramp") == 0)
+				CHECK(mean[M72_PRED_TREND] < mean[M72_PRED_LAST]);
+		}
+
+		free(seq->cnt);
+		free(seq);
+	}
+
+	M72_Exit(&G_llHdl);
+	return(HostResult("m72_pred_bench"));
+}
+
+/********************************* Rand *************************************
+ *
+ *  Description: Deterministic pseudo random number
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: range	  max. absolute value
+ *  Output.....: return   -range..range
+ *  Globals....: G_rand
+ ****************************************************************************/
+static int32 Rand(int32 range)
+{
+	G_rand = G_rand * 1103515245 + 12345;
+	return((int32)((G_rand >> 8) % (2 * range + 1)) - range);
+}
+
+/********************************* PeriodMake **********************************
+ *
+ *  Description: Make synthetic period sequence
+ *
+ *               constant  PERIOD
+ *               jitter    PERIOD +-200 ticks
+ *               ramp      PERIOD + 2 ticks per period
+ *               drift     ramp +-50 ticks
+ *               outliers  jitter, every 101st edge missing (double period)
+ *               step      jitter, period drops by 30% after half sequence
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: name	  sequence name
+ *  Output.....: return   sequence or NULL
+ *  Globals....: -
+ ****************************************************************************/
+static PERIODS *PeriodMake(const char *name)
+{
+	PERIODS *seq = (PERIODS*)malloc(sizeof(PERIODS));
+	u_int32 n, p;
+
+	seq->name = name;
+	seq->num  = SEQ_LEN;
+	seq->cnt  = (u_int32*)malloc(SEQ_LEN * sizeof(u_int32));
+
+	for (n=0; n<SEQ_LEN; n++) {
+		p = PERIOD;
+
+		if (strcmp(name, "jitter") == 0)
+			p += Rand(200);
+		else if (strcmp(name, "ramp") == 0)
+			p += 2 * n;
+		else if (strcmp(name, "drift") == 0)
+			p += 2 * n + Rand(50);
+		else if (strcmp(name, "outliers") == 0)
+			p = (n % 101 == 100 ? 2 * PERIOD : PERIOD) + Rand(200);
+		else if (strcmp(name, "step") == 0)
+			p = (n < SEQ_LEN / 2 ? PERIOD : PERIOD * 7 / 10) + Rand(200);
+
+		seq->cnt[n] = p;
+	}
+
+	return(seq);
+}
+
+/********************************* PeriodLoad **********************************
+ *
+ *  Description: Load recorded period sequence
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: file	  file name (one period per line, dec or 0x hex)
+ *  Output.....: return   sequence or NULL
+ *  Globals....: -
+ ****************************************************************************/
+static PERIODS *PeriodLoad(const char *file)
+{
+	PERIODS *seq;
+	FILE *fp;
+	long val;
+
+	if ((fp = fopen(file, "r")) == NULL) {
+		printf("*** can't open %s\n", file);
+		return(NULL);
+	}
+
+	seq = (PERIODS*)malloc(sizeof(PERIODS));
+	seq->name = "recorded";
+	seq->num  = 0;
+	seq->cnt  = (u_int32*)malloc(SEQ_MAX * sizeof(u_int32));
+
+	while (seq->num < SEQ_MAX && fscanf(fp, "%li", &val) == 1)
+		seq->cnt[seq->num++] = (u_int32)val;
+
+	fclose(fp);
+	return(seq);
+}
+
+/********************************* Run **************************************
+ *
+ *  Description: Run sequence through predictor, print results
+ *
+ *               The error of a period is taken against the prediction
+ *               made at the end of the previous period.
+ *
+ *---------------------------------------------------------------------------
+ *  Input......: seq	  sequence
+ *               mode     M72_PRED_xxx
+ *               k        M72_PRETRIG_PRED_K
+ *               modeName mode name
+ *  Output.....: return   mean period error [ticks]
+ *  Globals....: G_llHdl
+ ****************************************************************************/
+static double Run(PERIODS *seq, u_int32 mode, u_int32 k, const char *modeName)
+{
+	PRETRIG_STAT *st = &G_llHdl->ptStat;
+	u_int32 p = G_llHdl->ptPeriod, fracClr = G_llHdl->ptFracClr;
+	u_int32 n, cnt, pred = 0, err, errMax = 0, edge, edgeMax = 0, outl;
+	u_int64 errSum = 0, edgeSum = 0, c0, predCyc, irqCyc;
+
+	G_llHdl->ptPredMode = mode;
+	G_llHdl->ptPredK    = k;
+	G_llHdl->ptBand     = BAND;
+
+	/*--- prediction error ---*/
+	PretrigPredReset(G_llHdl, 0);
+	PretrigStatClear(G_llHdl);
+
+	for (n=0; n<seq->num; n++) {
+		cnt = seq->cnt[n];
+
+		if (n) {
+			err  = cnt > pred ? cnt - pred : pred - cnt;
+			edge = PretrigFrac(cnt, fracClr);
+			edge = edge > PretrigFrac(pred, fracClr) ?
+				edge - PretrigFrac(pred, fracClr) :
+				PretrigFrac(pred, fracClr) - edge;
+
+			errSum  += err;
+			edgeSum += edge;
+			if (err > errMax)
+				errMax = err;
+			if (edge > edgeMax)
+				edgeMax = edge;
+		}
+
+		pred = PretrigPredict(G_llHdl, cnt);
+	}
+
+	/* driver statistics must agree */
+	CHECK(st->errMax == errMax);
+	CHECK((((u_int64)st->errHigh << 32) | st->errLow) == errSum);
+	if (strcmp(seq->name, "constant") == 0)
+		CHECK(errMax == 0);
+	outl = st->outliers;
+
+	/*--- cycles: PretrigPredict ---*/
+	PretrigPredReset(G_llHdl, 0);
+	c0 = HostCycles();
+	for (n=0; n<seq->num; n++)
+		PretrigPredict(G_llHdl, seq->cnt[n]);
+	predCyc = HostCycles() - c0;
+
+	/*--- cycles: PretrigIrq (incl. two register stores per period) ---*/
+	PretrigPredReset(G_llHdl, 0);
+	G_llHdl->enPretrig = TRUE;
+	c0 = HostCycles();
+	for (n=0; n<seq->num; n++) {
+		G_hostRegs[COUNT_LOW_REG(p) / 2]  = (u_int16)seq->cnt[n];
+		G_hostRegs[COUNT_HIGH_REG(p) / 2] = (u_int16)(seq->cnt[n] >> 16);
+		PretrigIrq(G_llHdl, XIN2_PEND(p));
+	}
+	irqCyc = HostCycles() - c0;
+	G_llHdl->enPretrig = FALSE;
+
+	printf("%-9s %-5s %u %10.1f %8u %10.1f %8u %5u %8.1f %8.1f\n",
+		   seq->name, modeName, k,
+		   seq->num > 1 ? (double)errSum / (seq->num - 1) : 0.0, errMax,
+		   seq->num > 1 ? (double)edgeSum / (seq->num - 1) : 0.0, edgeMax,
+		   outl,
+		   (double)predCyc / seq->num, (double)irqCyc / seq->num);
+
+	return(seq->num > 1 ? (double)errSum / (seq->num - 1) : 0.0);
+}
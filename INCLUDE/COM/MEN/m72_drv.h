@@ -39,7 +39,191 @@
 /*-----------------------------------------+
 |  TYPEDEFS                                |
 +-----------------------------------------*/
-/* none */
+/* M72 block read: coherent snapshot of all channels */
+typedef struct {
+	u_int32		count[4];		/* counter latch of channel 0..3 		*/
+	u_int32		intStatus;		/* irq status bits of channel 0..3 		*/
+								/* (channel n in bits n*8..n*8+4) 		*/
+} M72_SNAPSHOT;
+
+/* M72 block read: FIFO entry */
+typedef struct M72_FIFO_ENTRY {
+	u_int32		value;			/* counter latch 						*/
+	u_int32		seq;			/* sequence number (per channel) 		*/
+	u_int32		cause;			/* irq status bits (M72_INT_xxx) 		*/
+	u_int32		time;			/* timestamp of irq, bits 0..31 		*/
+								/* (see M72_TIME_RATE) 					*/
+	u_int32		timeHigh;		/* timestamp of irq, bits 32..63 		*/
+} M72_FIFO_ENTRY;
+
+/* M72 block read: event queue entry */
+typedef struct M72_EVENT {
+	u_int32		channel;		/* channel (0..3) 						*/
+	u_int32		cause;			/* irq status bits (M72_INT_xxx) 		*/
+	u_int32		value;			/* counter latch 						*/
+	u_int32		seq;			/* sequence number (per module) 		*/
+	u_int32		time;			/* timestamp of irq, bits 0..31 		*/
+								/* (see M72_TIME_RATE) 					*/
+	u_int32		timeHigh;		/* timestamp of irq, bits 32..63 		*/
+} M72_EVENT;
+
+/* M72 block getstat: 64-bit counter (M72_BLK_CNT64) */
+typedef struct {
+	u_int32		low;			/* counter bits 0..31 					*/
+	u_int32		high;			/* counter bits 32..63 (two's compl.) 	*/
+} M72_CNT64;
+
+/* M72 block setstat: comparator cam table (M72_BLK_CAM) */
+typedef struct M72_CAM {
+	u_int32		mode;			/* cam mode (M72_CAM_xxx) 				*/
+	u_int32		loop;			/* restart list at end (0..1) 			*/
+	u_int32		incr;			/* increment (M72_CAM_INCR) 			*/
+	u_int32		count;			/* number of table entries 				*/
+	u_int32		table[1];		/* compare positions (count entries) 	*/
+} M72_CAM;
+
+/* M72 block setstat: timer interval sequence (M72_BLK_SEQ) */
+typedef struct M72_SEQ {
+	u_int32		loop;			/* restart sequence at end (0..1) 		*/
+	u_int32		count;			/* number of intervals (0=stop) 		*/
+	u_int32		interval[1];	/* intervals [timer ticks] 				*/
+} M72_SEQ;
+
+/* M72 block getstat: pretrigger period statistics (M72_BLK_PRETRIG_STAT) */
+#define M72_PRETRIG_HIST_BINS	32		/* number of histogram bins */
+
+typedef struct {
+	u_int32		count;			/* number of periods 					*/
+	u_int32		min;			/* min. period [ticks] 					*/
+	u_int32		max;			/* max. period [ticks] 					*/
+	u_int32		mean;			/* mean period [ticks] 					*/
+	u_int32		variance;		/* variance [ticks^2] 					*/
+	u_int32		late;			/* late preloads 						*/
+	u_int32		histBase;		/* lower bound of bin 0 [ticks] 		*/
+	u_int32		histShift;		/* bin width = 1 << histShift [ticks] 	*/
+	u_int32		histUnder;		/* periods below bin 0 					*/
+	u_int32		histOver;		/* periods above last bin 				*/
+	u_int32		outliers;		/* rejected periods (M72_PRETRIG_BAND) 	*/
+	u_int32		errMean;		/* mean abs. prediction error [ticks] 	*/
+	u_int32		errMax;			/* max. abs. prediction error [ticks] 	*/
+	u_int32		latency;		/* last preload latency [ticks] 		*/
+	u_int32		latMax;			/* max. preload latency [ticks] 		*/
+	u_int32		latMean;		/* mean preload latency [ticks] 		*/
+	u_int32		compensated;	/* latency compensated edges 			*/
+	u_int32		missed;			/* edges not compensated (too late) 	*/
+	u_int32		hist[M72_PRETRIG_HIST_BINS];	/* histogram bins 		*/
+} M72_PRETRIG_STAT;
+
+/* M72 block getstat: ISR profile (M72_BLK_IRQ_PROFILE) */
+#define M72_PROFILE_BINS		32		/* number of histogram bins */
+
+typedef struct {
+	u_int32		rate;			/* duration clock rate [Hz] 			*/
+	u_int32		count;			/* measured interrupts 					*/
+	u_int32		durLast;		/* last ISR duration [clock] 			*/
+	u_int32		durMax;			/* max. ISR duration [clock] 			*/
+	u_int32		latRate;		/* latency clock rate [Hz] 				*/
+	u_int32		latCount;		/* latency samples 						*/
+	u_int32		latLast;		/* last event-to-ISR latency [clock] 	*/
+	u_int32		latMax;			/* max. event-to-ISR latency [clock] 	*/
+	u_int32		durHist[M72_PROFILE_BINS];	/* duration histogram 		*/
+	u_int32		latHist[M72_PROFILE_BINS];	/* latency histogram 		*/
+} M72_ISR_PROFILE;
+
+/* M72 block write: preload/load batch */
+typedef struct {
+	u_int32		chanMask;		/* channels to write (bit n = channel n) */
+	u_int32		loadNow;		/* force counter load after write (0..1) */
+	u_int32		preload[4];		/* preload value of channel 0..3 		*/
+} M72_PRELOAD_BATCH;
+
+/* M72 block setstat: setstat list entry (M72_BLK_SETSTAT_LIST) */
+typedef struct {
+	u_int32		ch;				/* channel (0..3) 						*/
+	int32		code;			/* status code (M72_xxx) 				*/
+	int32		value;			/* value 								*/
+} M72_SETSTAT_ENTRY;
+
+/* M72 block getstat: configuration of one channel (see M72_CONFIG) */
+typedef struct {
+	u_int32		cntMode;		/* M72_CNT_MODE 						*/
+	u_int32		cntPreload;		/* M72_CNT_PRELOAD 						*/
+	u_int32		cntClear;		/* M72_CNT_CLEAR 						*/
+	u_int32		cntStore;		/* M72_CNT_STORE 						*/
+	u_int32		timerStart;		/* M72_TIMER_START 						*/
+	u_int32		enbIrq;			/* M72_ENB_IRQ 							*/
+	u_int32		compIrq;		/* M72_COMP_IRQ 						*/
+	u_int32		cybwIrq;		/* M72_CYBW_IRQ 						*/
+	u_int32		lbreakIrq;		/* M72_LBREAK_IRQ 						*/
+	u_int32		xin2Irq;		/* M72_XIN2_IRQ 						*/
+	u_int32		valPreload;		/* preload value (last written) 		*/
+	u_int32		valCompA;		/* M72_VAL_COMPA 						*/
+	u_int32		valCompB;		/* M72_VAL_COMPB 						*/
+	u_int32		readMode;		/* M72_READ_MODE 						*/
+	u_int32		readTimeout;	/* M72_READ_TIMEOUT 					*/
+	u_int32		writeMode;		/* M72_WRITE_MODE 						*/
+	u_int32		blkReadMode;	/* M72_BLKREAD_MODE 					*/
+	u_int32		fifoEvents;		/* M72_FIFO_EVENTS 						*/
+	u_int32		fifoDepth;		/* M72_FIFO_DEPTH 						*/
+	u_int32		regCountCtrl;	/* counter control register (shadow) 	*/
+	u_int32		regIrqCtrl;		/* irq control register (shadow) 		*/
+	u_int32		intStatChan;	/* irq status bits (M72_INT_xxx) 		*/
+	u_int32		continuous;		/* M72_CONTINUOUS 						*/
+	u_int32		ext64;			/* M72_EXT64 							*/
+	u_int32		capture;		/* M72_CAPTURE 							*/
+	u_int32		camMode;		/* cam mode (M72_BLK_CAM) 				*/
+} M72_CONFIG_CHAN;
+
+/* M72 block getstat: configuration snapshot (M72_BLK_CONFIG) */
+typedef struct {
+	u_int32		version;		/* struct version (M72_CONFIG_VERSION) 	*/
+	u_int32		size;			/* struct size (bytes) 					*/
+	u_int32		irqCount;		/* interrupt counter 					*/
+	u_int32		regOutCtrl1;	/* output control register 1 (shadow) 	*/
+	u_int32		regOutCtrl2;	/* output control register 2 (shadow) 	*/
+	u_int32		timebase;		/* M72_TIMEBASE 						*/
+	M72_CONFIG_CHAN chan[4];	/* configuration of channel 0..3 		*/
+} M72_CONFIG;
+
+/*
+ * M72 event ring (shared between M72_Irq and applications)
+ *
+ * The ring holds 'size' records (power of 2). The driver writes record
+ * number 'head' to rec[head & (size-1)] and increments 'head' afterwards.
+ * The ring is never blocked by readers: old records are overwritten.
+ * Each reader keeps its own tail index and reads without system calls:
+ *
+ * - tail == head: ring empty
+ * - head - tail > size: records lost, continue with tail = head - size
+ * - else copy rec[tail & (size-1)], then re-read head. The copy is valid
+ *   if head - tail <= size still holds (record not overwritten meanwhile)
+ *   and the record's 'seq' equals tail. Else the record is lost, continue
+ *   with tail + 1.
+ *
+ * Applications read a copy of the ring (M72_BLK_EVRING). The ring itself
+ * (M72_EVRING_ADDR) is only exported if the driver was built with
+ * M72_EVRING_SHARED, i.e. on OSes where driver and applications share
+ * one address space.
+ *
+ * See example program m72_evring.
+ */
+typedef struct M72_EVRING_REC {
+	u_int32		channel;		/* channel number 						*/
+	u_int32		cause;			/* irq status bits (M72_INT_xxx) 		*/
+	u_int32		value;			/* counter latch 						*/
+	u_int32		seq;			/* record number 						*/
+	u_int32		time;			/* timestamp of irq, bits 0..31 		*/
+								/* (see M72_TIME_RATE) 					*/
+	u_int32		timeHigh;		/* timestamp of irq, bits 32..63 		*/
+} M72_EVRING_REC;
+
+typedef struct M72_EVRING {
+	u_int32		magic;			/* M72_EVRING_MAGIC 					*/
+	u_int32		size;			/* number of records 					*/
+	volatile u_int32 head;		/* number of written records 			*/
+	u_int32		reserved;
+	M72_EVRING_REC rec[1];		/* records (size entries) 				*/
+} M72_EVRING;
 
 /*-----------------------------------------+
 |  DEFINES                                 |
@@ -84,6 +268,62 @@
 #define M72_INT_STATUS      M_DEV_OF+0x42   /* G,S: IRQ status register 	 */
 #define M72_CNT_PRETRIG		M_DEV_OF+0x43 	/* G,S: Timer[0123] reload Val 	 */
 #define M72_EN_PRETRIG 		M_DEV_OF+0x44 	/* G,S: enable Pretrg within IRQ */
+#define M72_IRQ_REJECT		M_DEV_OF+0x45	/* G,S: rejected interrupts 	 */
+#define M72_IRQ_DEFER		M_DEV_OF+0x46	/* G,S: deferred irq work [ms] 	 */
+#define M72_DEFER_OVERRUN	M_DEV_OF+0x47	/* G,S: dropped deferred irqs 	 */
+#define M72_PROFILE_CLEAR	M_DEV_OF+0x48	/*   S: clear ISR profile 		 */
+
+#define M72_BLKREAD_MODE	M_DEV_OF+0x50	/* G,S: mode for block read calls */
+#define M72_FIFO_EVENTS		M_DEV_OF+0x51	/* G,S: irq events stored in FIFO */
+#define M72_FIFO_COUNT		M_DEV_OF+0x52	/* G  : number of FIFO entries	 */
+#define M72_FIFO_OVERRUN	M_DEV_OF+0x53	/* G,S: number of lost entries	 */
+#define M72_FIFO_CLEAR		M_DEV_OF+0x54	/*   S: flush FIFO 				 */
+#define M72_FIFO_DEPTH		M_DEV_OF+0x55	/* G  : FIFO depth (entries) 	 */
+#define M72_EVRING_ADDR		M_DEV_OF+0x56	/* G  : event ring address 		 */
+#define M72_EVQUEUE_COUNT	M_DEV_OF+0x57	/* G  : number of queued events  */
+#define M72_EVQUEUE_OVERRUN	M_DEV_OF+0x58	/* G,S: number of lost events 	 */
+#define M72_EVQUEUE_CLEAR	M_DEV_OF+0x59	/*   S: flush event queue 		 */
+#define M72_READ_SEQ		M_DEV_OF+0x5a	/* G  : seq. number of last read */
+#define M72_CONTINUOUS		M_DEV_OF+0x5b	/* G,S: continuous measurement  */
+#define M72_EXT64			M_DEV_OF+0x5c	/* G,S: 64-bit counter extension */
+#define M72_TIME_RATE		M_DEV_OF+0x5d	/* G  : timestamps per second 	 */
+#define M72_TIMEBASE		M_DEV_OF+0x5e	/* G,S: timebase channel 		 */
+#define M72_CAPTURE			M_DEV_OF+0x5f	/* G,S: xIN2 capture mode 		 */
+
+#define M72_TIME			M_DEV_OF+0x60
+#define M72_TIME_READY		M72_TIME+0x00	/* G  : time of last ready irq 	*/
+#define M72_TIME_COMP		M72_TIME+0x01	/* G  : time of last compare irq */
+#define M72_TIME_CYBW		M72_TIME+0x02	/* G  : time of last carry/borrow */
+#define M72_TIME_LBREAK		M72_TIME+0x03	/* G  : time of last linebreak 	*/
+#define M72_TIME_XIN2		M72_TIME+0x04	/* G  : time of last xIN2 irq 	*/
+
+#define M72_CAM_MATCHES		M_DEV_OF+0x70	/* G  : cam comparator matches  */
+#define M72_SEQ_UNDERRUN	M_DEV_OF+0x71	/* G,S: late sequence intervals */
+
+#define M72_PRETRIG			M_DEV_OF+0x80
+#define M72_PRETRIG_PERIOD	M72_PRETRIG+0x00 /* G,S: period timer channel 	*/
+#define M72_PRETRIG_SET		M72_PRETRIG+0x01 /* G,S: set edge timer channel */
+#define M72_PRETRIG_CLR		M72_PRETRIG+0x02 /* G,S: clr edge timer channel */
+#define M72_PRETRIG_FSET	M72_PRETRIG+0x03 /* G,S: set edge period fract. */
+#define M72_PRETRIG_FCLR	M72_PRETRIG+0x04 /* G,S: clr edge period fract. */
+#define M72_PRETRIG_OUT		M72_PRETRIG+0x05 /* G,S: pretrigger output line */
+#define M72_PRETRIG_HBASE	M72_PRETRIG+0x06 /* G,S: histogram bin 0 bound 	*/
+#define M72_PRETRIG_HSHIFT	M72_PRETRIG+0x07 /* G,S: histogram bin width 	*/
+#define M72_PRETRIG_SCLEAR	M72_PRETRIG+0x08 /*   S: clear period statistics */
+#define M72_PRETRIG_PRED	M72_PRETRIG+0x09 /* G,S: period predictor 		*/
+#define M72_PRETRIG_PRED_K	M72_PRETRIG+0x0a /* G,S: predictor window/gain 	*/
+#define M72_PRETRIG_BAND	M72_PRETRIG+0x0b /* G,S: outlier band 			*/
+#define M72_PRETRIG_LATCOMP	M72_PRETRIG+0x0c /* G,S: latency compensation 	*/
+
+/* M72 specific status codes (BLK) */		/* S,G: S=setstat, G=getstat 	 */
+#define M72_BLK_EVRING		M_DEV_BLK_OF+0x00 /* G: copy of event ring 		 */
+#define M72_BLK_SETSTAT_LIST M_DEV_BLK_OF+0x01 /* S: list of setstats 		 */
+#define M72_BLK_CONFIG		M_DEV_BLK_OF+0x02 /* G: configuration snapshot  */
+#define M72_BLK_CNT64		M_DEV_BLK_OF+0x03 /* G: 64-bit counter 			 */
+#define M72_BLK_CAM			M_DEV_BLK_OF+0x04 /* S: comparator cam table 	 */
+#define M72_BLK_SEQ			M_DEV_BLK_OF+0x05 /* S: timer interval sequence  */
+#define M72_BLK_PRETRIG_STAT M_DEV_BLK_OF+0x06 /* G: pretrigger statistics	 */
+#define M72_BLK_IRQ_PROFILE	M_DEV_BLK_OF+0x07 /* G: ISR profile 			 */
 
 /* M72 counter modes */
 #define M72_MODE_NO	   		0x00		/* no count (halted) */
@@ -132,6 +372,52 @@
 #define M72_READ_LATCH		0x00		/* read counter latch */
 #define M72_READ_WAIT		0x01		/* wait for ready irq before read */
 #define M72_READ_NOW		0x02		/* force counter latch before read */
+#define M72_READ_QUEUE		0x03		/* read values queued at ready irq */
+
+/* M72 block read modes */
+#define M72_BLKREAD_SNAPSHOT 0x00		/* snapshot of all channels */
+#define M72_BLKREAD_FIFO	0x01		/* drain FIFO of current channel */
+#define M72_BLKREAD_EVQUEUE	0x02		/* wait for/drain event queue */
+
+/* comparator cam modes (M72_BLK_CAM) */
+#define M72_CAM_OFF			0x00		/* no cam table */
+#define M72_CAM_LIST		0x01		/* compare positions from table */
+#define M72_CAM_INCR		0x02		/* table[0], then add increment */
+#define M72_CAM_SEQ			0x80		/* interval sequence (M72_BLK_SEQ) */
+
+#define M72_CAM_SIZE(n)		(sizeof(M72_CAM) + ((n)-1) * sizeof(u_int32))
+
+/* timer interval sequence (M72_BLK_SEQ) */
+#define M72_SEQ_SIZE(n)		(sizeof(M72_SEQ) + ((n)-1) * sizeof(u_int32))
+
+/* pretrigger edge fraction (M72_PRETRIG_FSET/FCLR) */
+#define M72_PRETRIG_FRAC_ONE 0x10000	/* full period */
+
+/* pretrigger period predictor (M72_PRETRIG_PRED) */
+#define M72_PRED_LAST		0			/* last period */
+#define M72_PRED_AVG		1			/* moving average */
+#define M72_PRED_EXP		2			/* exponential smoothing */
+#define M72_PRED_TREND		3			/* linear trend (double exp.) */
+#define M72_PRED_K_MAX		4			/* max. M72_PRETRIG_PRED_K */
+
+/* timebase channel (M72_TIMEBASE) */
+#define M72_TIMEBASE_OFF	0xffffffff	/* timestamps from OS */
+
+/* configuration snapshot version (M72_CONFIG)
+   1: initial layout
+   2: M72_CONFIG.timebase
+   3: M72_CONFIG_CHAN.continuous appended
+   4: M72_CONFIG_CHAN.ext64 appended
+   5: M72_CONFIG_CHAN.capture appended
+   6: M72_CONFIG_CHAN.camMode appended */
+#define M72_CONFIG_VERSION	6
+
+/* M72 interrupt status flags (M72_INT_STATUS, M72_FIFO_EVENTS) */
+#define M72_INT_READY		0x01		/* Ready */
+#define M72_INT_COMP		0x02		/* Comparator */
+#define M72_INT_CYBW		0x04		/* Carry/Borrow */
+#define M72_INT_LBREAK		0x08		/* Line-Break */
+#define M72_INT_XIN2		0x10		/* xIN2 Edge */
 
 /* M72 write mode flags */
 #define M72_WRITE_PRELOAD	0x00		/* write preload value */
@@ -160,6 +446,21 @@
 #define M72_OUT_SET_CTRL3	0x04		/* Control_3 signal */
 #define M72_OUT_SET_CTRL4	0x08		/* Control_4 signal */
 
+/* M72 event ring */
+#define M72_EVRING_MAGIC	0x4d373252	/* 'M72R' */
+#define M72_EVRING_SIZE(n)	(sizeof(M72_EVRING) + \
+							 ((n)-1) * sizeof(M72_EVRING_REC))
+
+/* memory barrier for event ring access (required by the ring protocol,
+   other compilers must define it, e.g. -DM72_EVRING_BARRIER()=...) */
+#ifndef M72_EVRING_BARRIER
+# ifdef __GNUC__
+#  define M72_EVRING_BARRIER()	__sync_synchronize()
+# else
+#  error "M72_EVRING_BARRIER must be defined for this compiler"
+# endif
+#endif
+
 /*-----------------------------------------+
 |  PROTOTYPES                              |
 +------------------------------------------*/
@@ -167,10 +468,8 @@
 #ifndef _ONE_NAMESPACE_PER_DRIVER_
 # ifdef MAC_BYTESWAP
 	extern void M72_SW_GetEntry(LL_ENTRY* drvP);
-	extern void M72_PRE_SW_GetEntry(LL_ENTRY* drvP);
 # else
 	extern void M72_GetEntry(LL_ENTRY* drvP);
-	extern void M72_PRE_GetEntry(LL_ENTRY* drvP);
 # endif
 #endif
 #endif /* _LL_DRV_ */